@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "config.h"
+
+// Highest log level that is compiled in at all. Calls above it compile to nothing, so debug logging can be left in hot paths.
+#ifndef HIGGS_LOG_MAX_LEVEL
+#ifdef _DEBUG
+#define HIGGS_LOG_MAX_LEVEL IDebugLog::kLevel_DebugMessage
+#else
+#define HIGGS_LOG_MAX_LEVEL IDebugLog::kLevel_VerboseMessage
+#endif
+#endif
+
+
+// Logging for code that runs every frame. The format string and a copy of the arguments are pushed to a lock-free queue,
+// and the actual formatting and writing to the log file happens on a background thread.
+// Format strings must be string literals (or otherwise outlive the plugin), since only the pointer is kept.
+namespace AsyncLog {
+    enum class Category : UInt8
+    {
+        General,
+        Selection,
+        Grab,
+        Geometry,
+        Fingers,
+        Physics,
+
+        Count
+    };
+
+    // Current level of the category: its own logLevel<Category> setting if that is set, otherwise logLevel
+    int GetLevel(Category category);
+
+    inline bool IsEnabled(Category category, IDebugLog::LogLevel level)
+    {
+        return level <= GetLevel(category);
+    }
+
+    // String arguments are copied, as the caller's buffer may be gone by the time the message is formatted
+    struct CapturedString
+    {
+        char data[64];
+    };
+
+    template <class T>
+    inline T Capture(const T &val) { return val; }
+    inline CapturedString Capture(const char *str)
+    {
+        CapturedString captured;
+        strncpy_s(captured.data, str ? str : "(null)", _TRUNCATE);
+        return captured;
+    }
+    inline CapturedString Capture(char *str) { return Capture((const char *)str); }
+    template <size_t N>
+    inline CapturedString Capture(const char (&str)[N]) { return Capture((const char *)str); }
+
+    template <class T>
+    inline const T & Unwrap(const T &val) { return val; }
+    inline const char * Unwrap(const CapturedString &str) { return str.data; }
+
+    typedef int(*FormatFunc)(char *buffer, size_t bufferSize, const char *fmt, const void *args);
+
+    template <class Tuple, size_t... I>
+    int FormatTuple(char *buffer, size_t bufferSize, const char *fmt, const Tuple &args, std::index_sequence<I...>)
+    {
+        return snprintf(buffer, bufferSize, fmt, Unwrap(std::get<I>(args))...);
+    }
+
+    template <class Tuple>
+    int Format(char *buffer, size_t bufferSize, const char *fmt, const void *args)
+    {
+        return FormatTuple(buffer, bufferSize, fmt, *(const Tuple *)args, std::make_index_sequence<std::tuple_size_v<Tuple>>());
+    }
+
+    constexpr size_t g_maxArgsSize = 224;
+
+    struct Record; // one slot of the queue
+
+    // Claims a slot in the queue. Returns null if the queue is full, in which case the message is dropped and counted.
+    Record * BeginRecord();
+    void * GetArgsStorage(Record *record);
+    void CommitRecord(Record *record, const char *fmt, FormatFunc format);
+
+    // Level checks are done by the HIGGS_LOG macros, so that disabled messages don't even evaluate their arguments
+    template <class... Args>
+    void Write(const char *fmt, const Args &... args)
+    {
+        using Tuple = std::tuple<decltype(Capture(args))...>;
+        static_assert(sizeof(Tuple) <= g_maxArgsSize, "Log arguments are too large to be queued");
+        static_assert(std::is_trivially_copyable_v<Tuple> && std::is_trivially_destructible_v<Tuple>, "Log arguments must be plain values");
+
+        Record *record = BeginRecord();
+        if (!record) return;
+
+        new (GetArgsStorage(record)) Tuple(Capture(args)...);
+        CommitRecord(record, fmt, &Format<Tuple>);
+    }
+
+    // Starts the thread that writes out queued messages. Called once the config has been read.
+    void Start();
+    // Formats and writes out everything that is currently queued, on the calling thread. Also done when the process exits.
+    void Flush();
+
+    // Write to gLog right away, on the calling thread. IDebugLog isn't thread-safe and the writer thread uses it too,
+    // so these take the same lock as it does, and must be used instead of SKSE's _MESSAGE and co.
+    void FatalError(const char *fmt, ...);
+    void Error(const char *fmt, ...);
+    void Warning(const char *fmt, ...);
+    void Message(const char *fmt, ...);
+    void VerboseMessage(const char *fmt, ...);
+    void DebugMessage(const char *fmt, ...);
+}
+
+#define HIGGS_LOG(category, level, fmt, ...) \
+    do { \
+        if constexpr ((level) <= HIGGS_LOG_MAX_LEVEL) { \
+            if (AsyncLog::IsEnabled(AsyncLog::Category::category, level)) { \
+                AsyncLog::Write(fmt, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+#define HIGGS_MESSAGE(category, fmt, ...) HIGGS_LOG(category, IDebugLog::kLevel_Message, fmt, __VA_ARGS__)
+#define HIGGS_VMESSAGE(category, fmt, ...) HIGGS_LOG(category, IDebugLog::kLevel_VerboseMessage, fmt, __VA_ARGS__)
+#define HIGGS_DMESSAGE(category, fmt, ...) HIGGS_LOG(category, IDebugLog::kLevel_DebugMessage, fmt, __VA_ARGS__)
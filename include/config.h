@@ -29,6 +29,9 @@ namespace Config {
         float widePullGrabRadius = 0.9f;
         float nearbyGrabBodyRadius = 0.1f;
         float requiredCastDotProduct = cosf(50.0f * 0.0174533);
+        double farCastCoherenceMaxAge = 0.1; // in s, how long the far cast's hits can be reused for while the hand stays still. 0 to sweep every frame.
+        float farCastCoherenceMaxDistance = 0.01f; // in m, how far the hand can move before the far cast is swept again
+        float farCastCoherenceMaxAngle = 1.0f; // in degrees, how far the pointing direction can turn before the far cast is swept again
         float rolloverScale = 10.0f;
         float pullSpeedThreshold = 1.2f; // m/s
         float grabStartSpeed = 200.0f; // skyrim units/s
@@ -52,6 +55,8 @@ namespace Config {
         float throwVelocityThreshold = 1.0f; // m/s
         float throwVelocityBoostFactor = 1.0f;
         double throwIgnoreHandCollisionTime = 0.1; // in s, amount of time to ignore hand collisions after throwing
+        int velocityHistoryLength = 5; // number of controller / player / held object velocity samples to average or take the peak of
+        double throwVelocityEstimationWindow = 0; // in s, controller velocities from this far back are fit to estimate the velocity when letting go. 0 to use the peak of the last few frames instead.
 
         bool enableWeaponTwoHanding = true;
         bool offhandAffectsTwoHandedRotation = true;
@@ -151,6 +156,15 @@ namespace Config {
         double rolloverAfterDropAlphaFadeInTime = 1.0;
 
         int logLevel = IDebugLog::kLevel_Message;
+        // Per-category levels for the frequent messages that go through AsyncLog. -1 means use logLevel.
+        int logLevelSelection = -1;
+        int logLevelGrab = -1;
+        int logLevelGeometry = -1;
+        int logLevelFingers = -1;
+        int logLevelPhysics = -1;
+
+        bool enableProfiler = false; // time the main update phases, see Profiler. Stats are available through the plugin interface.
+        int profilerTraceFrames = 0; // if > 0, the next this many frames are written to higgs_trace.json in the chrome://tracing format
 
         bool enableWeaponCollision = true;
         bool forcePhysicsGrab = false;
@@ -176,10 +190,14 @@ namespace Config {
         float minPhysicsFrameRate = 70.f;
         int maxNumPhysicsStepsPerUpdate = 3;
         int maxNumPhysicsStepsPerUpdateComplex = 3;
+        bool enableAdaptivePhysicsSteps = false; // take fewer physics steps per frame when havok is taking longer than physicsStepBudgetMs, see PhysicsStepScheduler
+        float physicsStepBudgetMs = 4.f; // target time spent stepping havok per frame
+        int physicsStepHysteresisFrames = 10; // frames the step budget has to allow a new number of steps for in a row before switching to it
+        bool deterministicPhysicsSteps = false; // for tuning: use deterministicPhysicsStepCostMs as the base cost of a step instead of measuring it
+        float deterministicPhysicsStepCostMs = 1.f;
 
         bool enableShadowUpdateFix = true;
         int numShadowUpdates = 1;
-        int maxNumEntitiesPerSimulationIslandToCheck = 50;
         float maxDistanceOfSimulationIslandToUpdate = 25.0f; // meters
 
         float grabConstraintLinearMaxForceActor = 2500.f;
@@ -362,26 +380,16 @@ namespace Config {
         std::set<std::string, std::less<>> grabNodeNameBlacklist;
     };
     extern Options options; // global object containing options
-
-    extern std::map<std::string, float*, std::less<>> floatMap;
-    extern std::map<std::string, double*, std::less<>> doubleMap;
-    extern std::map<std::string, int*, std::less<>> intMap;
-    extern std::map<std::string, bool*, std::less<>> boolMap;
+    extern UInt32 g_optionsVersion; // incremented whenever any option changes, for anything that caches values derived from them
 
     // Fills Options struct from INI file
     bool ReadConfigOptions();
 
+    // By the name in g_settings (settings_schema.h)
     bool SetSettingDouble(const std::string_view& name, double val);
     bool GetSettingDouble(const std::string_view& name, double& out);
 
     bool ReloadIfModified();
 
     const std::string & GetConfigPath();
-
-    std::string GetConfigOption(const char * section, const char * key);
-
-    bool GetConfigOptionDouble(const char *section, const char *key, double *out);
-    bool GetConfigOptionFloat(const char *section, const char *key, float *out);
-    bool GetConfigOptionInt(const char *section, const char *key, int *out);
-    bool GetConfigOptionBool(const char *section, const char *key, bool *out);
 }
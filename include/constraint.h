@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <map>
+
 #include "RE/havok.h"
+#include "math_utils.h"
 
 
 class GrabConstraintData : public hkpConstraintData
@@ -121,3 +125,66 @@ public:
 };
 
 float GetMaxForceForFPS(float fps, std::map<float, float> &fpsToMaxForceMap);
+
+// The grab constraint motor settings for one held object, baked from the config when the object is grabbed or the config changes,
+// so that updating the motors each frame is just a few lookups.
+struct GrabMotorProfile
+{
+    static constexpr int numTableEntries = 256;
+
+    // Goes from start to end over some amount of time
+    struct Schedule
+    {
+        float Sample(double elapsedTime) const { return elapsedTime * invDuration >= 1.0 ? end : lerp(start, end, float(elapsedTime * invDuration)); }
+
+        float start = 0.f;
+        float end = 0.f;
+        double invDuration = 0.0;
+    };
+
+    struct MotorSettings
+    {
+        float proportionalRecoveryVelocity;
+        float constantRecoveryVelocity;
+        float damping;
+    };
+
+    float GetLinearMaxForceActor(float fps) const { return SampleTable(linearMaxForceActorByFPS, fps); }
+    float GetAngularMaxForceActor(float fps) const { return SampleTable(angularMaxForceActorByFPS, fps); }
+    float SampleTable(const float (&table)[numTableEntries], float fps) const
+    {
+        float x = std::clamp((fps - tableMinFPS) * invTableFPSStep, 0.f, float(numTableEntries - 1));
+        int i = (std::min)(int(x), numTableEntries - 2);
+        return lerp(table[i], table[i + 1], x - i);
+    }
+
+    UInt32 optionsVersion = UInt32(-1); // Config::g_optionsVersion this was built from
+    bool isActor = false;
+    bool isWeapon = false;
+
+    // Actors. Max forces are sampled evenly over the fps range covered by the fps multiplier maps, with the maps already applied.
+    // The maps are flat outside of their keys, so clamping to that range loses nothing.
+    float tableMinFPS;
+    float invTableFPSStep;
+    float linearMaxForceActorByFPS[numTableEntries];
+    float angularMaxForceActorByFPS[numTableEntries];
+    float linearTauActor;
+    float angularTauActor;
+    Schedule linearTauBody{}; // ragdolled actors, from the time they're held
+    Schedule angularTauBody{};
+
+    // Everything else
+    float linearMaxForce;
+    float maxForceToMassRatio;
+    Schedule angularToLinearForceRatioFadeIn{};
+    float angularToLinearForceRatio;
+    float linearTau;
+    float angularTau;
+    float collidingLinearTau;
+    float collidingAngularTau;
+    float tauLerpSpeed;
+
+    MotorSettings linearMotor;
+    MotorSettings angularMotor;
+};
+void BuildGrabMotorProfile(bool isActor, bool isWeapon, GrabMotorProfile &profileOut);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+
+// Tracks a deadline per key and hands back the keys whose deadlines have passed, in O(log n) per schedule and O(expired) per poll, instead of scanning every tracked key.
+// Rescheduling a key just pushes a new heap entry - the old entry is recognized as stale and skipped when it comes up, since it no longer matches the key's current deadline.
+template <class Key>
+struct DeadlineScheduler
+{
+    // Sets the deadline for the key, replacing any existing one
+    void Schedule(const Key &key, double deadline)
+    {
+        deadlines[key] = deadline;
+        heap.push_back({ deadline, key });
+        std::push_heap(heap.begin(), heap.end(), EntryCompare());
+    }
+
+    void Cancel(const Key &key) { deadlines.erase(key); }
+
+    bool IsScheduled(const Key &key) const { return deadlines.count(key) != 0; }
+
+    bool empty() const { return deadlines.empty(); }
+
+    // Calls func(key) for every key whose deadline is before now, and stops tracking those keys
+    template <class Func>
+    void PopExpired(double now, Func &&func)
+    {
+        while (!heap.empty() && heap.front().deadline < now) {
+            std::pop_heap(heap.begin(), heap.end(), EntryCompare());
+            Entry entry = heap.back();
+            heap.pop_back();
+
+            auto it = deadlines.find(entry.key);
+            if (it == deadlines.end() || it->second != entry.deadline) continue; // cancelled or rescheduled
+
+            deadlines.erase(it);
+            func(entry.key);
+        }
+    }
+
+    void Clear()
+    {
+        heap.clear();
+        deadlines.clear();
+    }
+
+private:
+    struct Entry
+    {
+        double deadline;
+        Key key;
+    };
+
+    struct EntryCompare
+    {
+        bool operator()(const Entry &a, const Entry &b) const { return a.deadline > b.deadline; } // min-heap
+    };
+
+    std::vector<Entry> heap{};
+    std::unordered_map<Key, double> deadlines{};
+};
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "skse64/GameData.h"
 
@@ -123,5 +123,19 @@ extern ShaderReferenceEffect ** volatile g_shaderReferenceToSet;
 extern PlayingShader g_playingShaders[];
 extern std::unordered_map<NiAVObject *, NiPointer<ShaderReferenceEffect>> g_effectDataMap;
 
-extern std::unordered_map<ShaderReferenceEffect *, std::unordered_set<BSGeometry *>> g_shaderNodes; // Map root node to set of geom off of that root
-extern std::shared_mutex g_shaderNodesLock;
+// The geometry that each shader reference is allowed to play on. Snapshots are immutable once published, and are replaced as a whole when anything changes,
+// so that the render thread can check them without taking a lock.
+struct ShaderNodeSnapshot
+{
+    struct Entry
+    {
+        ShaderReferenceEffect *shaderReference;
+        std::vector<BSGeometry *> geometry; // sorted
+    };
+
+    bool Contains(ShaderReferenceEffect *shaderReference, BSGeometry *geometry) const;
+
+    std::vector<Entry> entries;
+};
+// Safe to call from any thread. Never blocks.
+bool IsShaderNodeGeometry(ShaderReferenceEffect *shaderReference, BSGeometry *geometry);
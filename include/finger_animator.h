@@ -21,14 +21,20 @@ struct FingerAnimator
     }
 
     NiPoint3 LerpFingerPosition(int finger, int knuckle, float lerpVal);
-    NiMatrix33 LerpFingerRotation(int finger, int knuckle, float lerpVal);
+    NiQuaternion LerpFingerRotation(int finger, int knuckle, float lerpVal);
     void Update();
     void SetFingerValues(float values[5], float linearSpeed, float angularSpeed, bool useAlternateThumb = false);
     void SetFingerValues(float value, float linearSpeed, float angularSpeed, bool useAlternateThumb = false);
     void RestoreFingers();
+    bool UpdateFingerNodes();
 
     BSFixedString fingerNodeNames[5][3];
-    NiTransform localTransforms[5][3];
+    NiPointer<NiAVObject> fingerNodes[5][3];
+    UInt32 fingerNodesGeneration = 0;
+    bool haveFingerNodes = false;
+    // Our last local transforms for the finger nodes, kept in quaternion form and only converted to a matrix when written to the nodes
+    NiPoint3 localPositions[5][3];
+    NiQuaternion localRotations[5][3];
     double restoreFingersTime;
     float animValues[5];
     int animCurves[5];
@@ -26,6 +26,17 @@ extern NiPoint3 g_closedFingerPositions[6][3];
 extern NiQuaternion g_openFingerRotations[6][3];
 extern NiQuaternion g_closedFingerRotations[6][3];
 
+// The open/closed finger poses, per hand. The right hand is a copy of the tables above, the left hand is mirrored across the hand's x axis.
+struct FingerPoseTable
+{
+    NiPoint3 openPositions[6][3];
+    NiPoint3 closedPositions[6][3];
+    NiQuaternion openRotations[6][3];
+    NiQuaternion closedRotations[6][3];
+};
+extern FingerPoseTable g_fingerPoseTables[2]; // [0] = right, [1] = left
+void ComputeFingerPoseTables();
+
 extern NiPoint3 g_fingerZeroAngleVecs[6];
 extern NiPoint3 g_fingerNormals[6];
 extern NiPoint3 g_fingerStartPositions[6];
@@ -9,14 +9,20 @@
 
 #include "RE/havok.h"
 #include "physics.h"
+#include "constraint.h"
 #include "utils.h"
 #include "haptics.h"
 #include "finger_animator.h"
+#include "ring_buffer.h"
+#include "pose_history.h"
+#include "selection_query.h"
 #include "config.h"
 
 #include <Physics/Collide/Shape/Convex/Box/hkpBoxShape.h>
 
 
+constexpr int g_maxVelocityHistoryLength = 64; // upper limit for Config::options.velocityHistoryLength
+
 struct Hand
 {
     struct SelectedObject
@@ -30,7 +36,7 @@ struct Hand
         NiPointer<NiAVObject> hitNode;
         std::unordered_map<bhkRigidBody *, hkInt16> savedContactPointCallbackDelays;
         std::unordered_map<bhkRigidBody *, NiPoint3> savedInverseInertias;
-        std::deque<NiPoint3> localLinearVelocities{ 5, NiPoint3() };
+        VelocityHistory<g_maxVelocityHistoryLength> localLinearVelocities{ Config::options.velocityHistoryLength };
         std::vector<hkpRigidBody *> collisionIgnoredBodies{}; // NOT smart pointer, only for lookups / comparisons
         std::mutex collisionIgnoredBodiesLock{};
         NiPoint3 point; // in meters (havok), the last point that was selected by the collision checks
@@ -55,6 +61,17 @@ struct Hand
         hkHalf savedAngularDamping;
     };
 
+    // The selected object's reference and nodes, resolved once per frame in PreUpdate so that every state in Update doesn't have to look them up again
+    struct ResolvedSelection
+    {
+        UInt32 handle = 0; // the selectedObject.handle this was resolved for
+        hkpCollidable *collidable = nullptr; // the selectedObject.collidable this was resolved for
+        NiPointer<TESObjectREFR> ref = nullptr;
+        NiPointer<NiNode> root = nullptr;
+        NiPointer<NiAVObject> collidableNode = nullptr;
+        bool isValid = false;
+    };
+
     struct TwoHandedState
     {
         enum class AngleState : UInt8 {
@@ -80,24 +97,19 @@ struct Hand
 
     struct ControllerTrackingData
     {
-        std::deque<NiPoint3> linearVelocities{ 5, NiPoint3() };
-        std::deque<NiPoint3> angularVelocities{ 5, NiPoint3() };
+        VelocityHistory<g_maxVelocityHistoryLength> linearVelocities{ Config::options.velocityHistoryLength };
+        VelocityHistory<g_maxVelocityHistoryLength> angularVelocities{ Config::options.velocityHistoryLength };
         NiPoint3 avgVelocity;
         float avgSpeed;
 
         void RecomputeAverageVelocity()
         {
-            avgVelocity = std::accumulate(linearVelocities.begin(), linearVelocities.end(), NiPoint3()) / linearVelocities.size();
+            avgVelocity = linearVelocities.AverageVelocity();
         }
 
         void RecomputeAverageSpeed()
         {
-            float speed = 0;
-            for (NiPoint3 &velocity : linearVelocities) {
-                speed += VectorLength(velocity);
-            }
-            speed /= std::size(linearVelocities);
-            avgSpeed = speed;
+            avgSpeed = linearVelocities.AverageSpeed();
         }
 
         void Recompute()
@@ -199,11 +211,11 @@ struct Hand
     void PlaySelectionEffect(UInt32 objHandle, NiAVObject *node);
     void StopSelectionEffect(UInt32 objHandle, NiAVObject *node);
     void StartNearbyDamping(bhkWorld &world);
-    bool FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &hkPalmNodePos, const NiPoint3 &castDirection, const bhkSimpleShapePhantom *sphere, bool isTwoHandedOffhand,
+    bool FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &hkPalmNodePos, const NiPoint3 &castDirection, bool isTwoHandedOffhand,
         NiPointer<TESObjectREFR> &closestObj, NiPointer<bhkRigidBody> &closestRigidBody, hkVector4 &closestPoint);
-    bool FindFarObject(bhkWorld *world, const Hand &other, const NiPoint3 &hkPalmNodePos, const NiPoint3 &castDirection, const NiPoint3 &hkHmdPos, const NiPoint3 &hmdForward, const bhkSimpleShapePhantom *sphere,
+    bool FindFarObject(bhkWorld *world, const Hand &other, const NiPoint3 &hkPalmNodePos, const NiPoint3 &castDirection, const NiPoint3 &hkHmdPos, const NiPoint3 &hmdForward,
         NiPointer<TESObjectREFR> &closestObj, NiPointer<bhkRigidBody> &closestRigidBody, hkVector4 &closestPoint);
-    bool FindOtherWeapon(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, const bhkSimpleShapePhantom *sphere, hkVector4 &hitPoint);
+    bool FindOtherWeapon(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, hkVector4 &hitPoint);
     void CreateHandCollision(bhkWorld *world);
     void RemoveHandCollision(bhkWorld *world);
     void RemoveHandCollisionFromCurrentWorld();
@@ -230,6 +242,14 @@ struct Hand
     void SetPulledDuration(const NiPoint3 &hkPalmNodePos, const NiPoint3 &objPoint);
     NiPointer<NiAVObject> GetFirstPersonHandNode();
     NiPointer<NiAVObject> GetThirdPersonHandNode();
+    NiPointer<NiAVObject> GetComNode();
+    void UpdateCachedPlayerNodes();
+    void ResolveSelection();
+    inline void InvalidateResolvedSelection() { resolvedSelection.isValid = false; }
+    bool LookupSelectedObject(NiPointer<TESObjectREFR> &selectedObjOut);
+    NiPointer<NiNode> GetSelectedRootNode();
+    NiPointer<NiAVObject> GetSelectedCollidableNode();
+    KeyframedNodeInfo & GetKeyframedNodeInfo(NiAVObject *node);
     NiPointer<NiAVObject> GetWeaponOffsetNode();
     NiPointer<NiAVObject> GetWeaponCollisionOffsetNode(TESObjectWEAP *weapon);
     NiPointer<NiAVObject> GetWeaponNode(bool thirdPerson);
@@ -245,7 +265,7 @@ struct Hand
     inline NiPoint3 GetPalmPositionWS(const NiTransform &handTransform) { return handTransform * palmPosHandspace; }
     NiPoint3 GetPalmVectorWS(NiMatrix33 &handRotation);
     NiPoint3 GetPointingVectorWS(NiMatrix33 &handRotation);
-    NiPoint3 GetHandVelocity();
+    void GetHandVelocities(NiPoint3 &linearVelocityOut, NiPoint3 &angularVelocityOut); // to throw the held object with, computed together so the pose history is only fit once
     bool IsObjectDepositable(TESObjectREFR *refr, NiAVObject *hmdNode, const NiPoint3 &handPos) const;
     bool IsObjectConsumable(TESObjectREFR *refr, NiAVObject *hmdNode, const NiPoint3 &handPos) const;
     bool IsTwoHanding() const;
@@ -291,6 +311,7 @@ struct Hand
     bool wasBeastWhenHandCollisionCreated = false;
 
     NiPointer<bhkRigidBody> weaponBody = nullptr; // Owned by us - this is our weapon collision
+    NiPointer<bhkShape> weaponShape = nullptr; // the (possibly shared) cloned shape that weaponBody uses
     hkpCollidable *weaponCollidable = nullptr; // read only
     std::optional<ShapeIdentifier> clonedFromWeaponShape = {}; // the shape of the collision object we cloned to create ours
     double weaponCollisionCreatedTime = 0.0;
@@ -305,6 +326,11 @@ struct Hand
     BSFixedString wandNodeName{};
     BSFixedString grabNodeOnObjectName{};
 
+    // Nodes looked up by name on the player's skeleton, re-resolved only when g_playerNodesGeneration changes
+    NiPointer<NiAVObject> cachedThirdPersonHandNode = nullptr;
+    NiPointer<NiAVObject> cachedComNode = nullptr;
+    UInt32 cachedPlayerNodesGeneration = 0;
+
     std::mutex deselectLock{};
 
     NiPoint3 rolloverOffset{};
@@ -317,12 +343,18 @@ struct Hand
     TESEffectShader *itemSelectedShaderOffLimits = nullptr;
 
     ControllerTrackingData controllerData{};
-    std::deque<NiPoint3> playerVelocitiesWorldspace{ 5, NiPoint3() }; // previous n player velocities in skyrim worldspace
+    PoseHistory poseHistory{}; // written from WaitPosesCB
+    VelocityHistory<g_maxVelocityHistoryLength> playerVelocitiesWorldspace{ Config::options.velocityHistoryLength }; // previous n player velocities in skyrim worldspace
     NiPoint3 avgPlayerVelocityWorldspace{};
     float avgPlayerSpeedWorldspace = 0.f;
 
     SelectedObject selectedObject{};
+    ResolvedSelection resolvedSelection{}; // only for use from the main thread
+    KeyframedNodeInfo keyframedNodeInfo{}; // for the held node, only for use from the main thread
+    ConstrainedBodySnapshot heldBodySnapshot{}; // while in State::HeldBody, only for use from the main thread
+    GrabMotorProfile grabMotorProfile{}; // baked motor settings for the held object, rebuilt when the config changes
     PulledObject pulledObject{};
+    HandSelectionQueries selectionQueries{}; // candidates from this frame's selection casts
     TwoHandedState twoHandedState{};
 
     NiPoint3 pulledPointOffset{}; // Offset from the center of mass of the point we're pulling on the pulled object
@@ -352,7 +384,7 @@ struct Hand
     std::vector<TriangleData> triangles{}; // tris are in worldspace
     NiTransform previousTriangleAdjustment{};
 
-    std::deque<float> handDeviations{ 5, 0.f };
+    RingBuffer<float, 5> handDeviations{ 5, 0.f };
     bool isSneaking = false;
     double sneakUnsneakTime = 0;
 
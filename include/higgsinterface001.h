@@ -128,6 +128,20 @@ namespace HiggsPluginAPI {
 
         // Get the name of the node that the given hand is currently grabbing, or an empty string if not grabbing a node or if the grabbed node has no name.
         virtual BSFixedString GetGrabbedNodeName(bool isLeft) = 0;
+
+        // Timings of higgs's update phases and hooks, over a rolling window of the last few hundred samples of each.
+        // These are only collected while the enableProfiler setting is on, which can be toggled with SetSettingDouble.
+        struct ProfilerZoneStats
+        {
+            const char *name; // valid for as long as the game is running
+            UInt32 numSamples;
+            float minMs;
+            float avgMs;
+            float p99Ms;
+            float maxMs;
+        };
+        virtual int GetNumProfilerZones() = 0;
+        virtual bool GetProfilerZoneStats(int zoneIndex, ProfilerZoneStats &statsOut) = 0;
     };
 }
 
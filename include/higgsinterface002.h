@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+
+#include "higgsinterface001.h"
+
+namespace HiggsPluginAPI {
+
+    // Returns an IHiggsInterface002 object compatible with the API shown below, or null if the installed HIGGS is too old to provide it
+    // This should only be called after SKSE sends kMessage_PostLoad to your plugin
+    struct IHiggsInterface002;
+    IHiggsInterface002 * GetHiggsInterface002(const PluginHandle & pluginHandle, SKSEMessagingInterface * messagingInterface);
+
+    // Revision 2 adds a per-frame snapshot of the state of both hands, so that everything can be read at once instead of through a dozen calls
+    struct IHiggsInterface002 : IHiggsInterface001
+    {
+        // Same values and order as HIGGS's internal hand states
+        enum class HandState : UInt8 {
+            Idle, // not pointing at anything meaningful
+            SelectedFar, // pointing at something meaningful that isn't close
+            SelectedClose, // pointing at something that's next to the hand
+            SelectionLocked, // player has locked in their selection, i.e. is holding the button
+            PreGrabItem, // player wants to grab an object that isn't loaded yet
+            PrePullItem, // player wants to pull a piece of armor off, wait for it to spawn
+            Pulled, // first few frames when a player is pulling the object towards them
+            HeldInit, // held object is moving towards hand
+            Held, // player is holding the object in their hand
+            HeldBody, // player is holding a body / other constrained object
+            GrabFromOtherHand, // waiting for the other hand to drop the object so that this one can grab it
+            GrabExternal, // going to grab an object requested through GrabObject
+            LootOtherHand, // going to loot from what the other hand is holding
+            SelectedTwoHand,
+            HeldTwoHanded,
+        };
+
+        struct HandSnapshot
+        {
+            HandState state;
+            bool isHoldingObject; // same as IsHoldingObject
+            bool isInGrabbableState; // same as IsHandInGrabbableState
+            bool isDisabled; // same as IsDisabled
+            bool isWeaponCollisionDisabled; // same as IsWeaponCollisionDisabled
+            bool isHeldObjectColliding; // whether the held object touched anything during the last physics step
+            bool canGrabObject; // same as CanGrabObject. Added in kStateSnapshotVersion 2, always false before that.
+            UInt8 pad07;
+            UInt32 selectedHandle; // refr handle of the selected / pulled / held object, or 0
+            UInt32 heldHandle; // refr handle of the held object, or 0 if not holding anything
+            float fingerValues[5]; // same as GetFingerValues
+            NiTransform grabTransform; // same as GetGrabTransform
+            NiPoint3 handLinearVelocity; // latest controller velocity as reported by the headset (m/s), rotated into skyrim worldspace
+            NiPoint3 handAngularVelocity; // radians / s, also worldspace
+        };
+
+        struct StateSnapshot
+        {
+            UInt32 version; // kStateSnapshotVersion of the HIGGS that wrote it. Fields are only ever added at the end.
+            UInt32 size; // sizeof(StateSnapshot) of the HIGGS that wrote it
+            UInt32 frameCount; // incremented every time a snapshot is published, which is once per frame after both hands have updated
+            bool isTwoHanding; // same as IsTwoHanding
+            UInt8 pad0D[3];
+            double frameTime; // HIGGS's frame time when this was published, in seconds
+            HandSnapshot hands[2]; // indexed by isLeft, i.e. right hand first
+        };
+        static constexpr UInt32 kStateSnapshotVersion = 2;
+
+        // Written by HIGGS, read by anyone. sequence is odd while a write is in progress.
+        struct StateSnapshotBuffer
+        {
+            std::atomic<UInt32> sequence;
+            StateSnapshot snapshot;
+        };
+
+        // Pointer to the snapshot that HIGGS keeps up to date. It stays valid for as long as the game is running. Read it with ReadStateSnapshot.
+        virtual const StateSnapshotBuffer * GetStateSnapshotBuffer() = 0;
+
+        // Copies out the latest snapshot. Returns false if nothing has been published yet.
+        virtual bool GetStateSnapshot(StateSnapshot &snapshotOut) = 0;
+
+        // Copies out the snapshot without making any calls into HIGGS. Retries if HIGGS was in the middle of writing it, which only takes a memcpy.
+        // Returns false if nothing has been published yet, or if the snapshot never stayed still for long enough to copy.
+        static bool ReadStateSnapshot(const StateSnapshotBuffer *buffer, StateSnapshot &snapshotOut)
+        {
+            for (int attempt = 0; attempt < 64; attempt++) {
+                UInt32 sequenceBefore = buffer->sequence.load(std::memory_order_acquire);
+                if (sequenceBefore == 0) return false;
+                if (sequenceBefore & 1) continue;
+
+                memcpy(&snapshotOut, &buffer->snapshot, sizeof(StateSnapshot));
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (buffer->sequence.load(std::memory_order_relaxed) == sequenceBefore) return true;
+            }
+            return false;
+        }
+    };
+}
+
+extern HiggsPluginAPI::IHiggsInterface002 * g_higgsInterface002;
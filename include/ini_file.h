@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+// An INI file read into memory in one pass, so that looking up a setting doesn't go back to the file.
+// Section and key names are case-insensitive, like GetPrivateProfileString. Only depends on the standard library.
+class IniFile
+{
+public:
+    struct Entry
+    {
+        std::string section;
+        std::string key;
+        std::string value;
+        int line;
+        mutable bool isRead = false; // whether Find() has returned it since the file was loaded
+    };
+
+    // Replaces the current contents. Returns false if the file could not be opened.
+    bool Load(const std::string &path);
+    void Parse(std::string_view text);
+    void Clear();
+
+    // Returns null if the key does not exist in the section. If a key is in a section more than once, the first one is used.
+    const std::string * Find(std::string_view section, std::string_view key) const;
+
+    // Entries of the section that have never been looked up, in file order
+    std::vector<const Entry *> GetUnreadEntries(std::string_view section) const;
+
+    const std::vector<Entry> & GetEntries() const { return entries; }
+
+private:
+    static std::string MakeIndexKey(std::string_view section, std::string_view key);
+
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, size_t> index; // lowercase "section]key" -> entry
+};
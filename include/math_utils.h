@@ -195,6 +195,7 @@ inline float logistic(float x, float k, float midpoint) { return 1.0f / (1.0f +
 float AdvanceFloat(float current, float target, float speed);
 NiPoint3 AdvancePosition(const NiPoint3 &currentPos, const NiPoint3 &targetPos, float speed);
 std::optional<NiTransform> AdvanceTransform(const NiTransform &currentTransform, const NiTransform &targetTransform, float posSpeed, float rotSpeed);
+bool AdvancePose(NiPoint3 &pos, NiQuaternion &rot, const NiPoint3 &targetPos, const NiQuaternion &targetRot, float posSpeed, float rotSpeed);
 std::optional<NiTransform> AdvanceTransformSpeedMultiplied(const NiTransform &currentTransform, const NiTransform &targetTransform, float posSpeedMult, float rotSpeedMult);
 float Determinant33(const NiMatrix33 &m);
 NiPoint3 QuadraticFromPoints(const NiPoint2 &p1, const NiPoint2 &p2, const NiPoint2 &p3);
@@ -3,7 +3,8 @@
 #include "skse64/GameReferences.h"
 
 #include "skse64/PapyrusVM.h"
-#include <unordered_map>
+#include <atomic>
+#include <iterator>
 #include "skse64/GameMenus.h"
 
 
@@ -12,12 +13,82 @@ namespace MenuChecker
 {
     const std::string MOD_VERSION = "1.0.0";
 
-    extern std::vector<std::string> gameStoppingMenus;
+    struct MenuInfo
+    {
+        const char *name;
+        bool stopsGame;
+    };
+
+    // Every menu that is tracked. A menu's ID is its index in here.
+    constexpr MenuInfo menus[] = {
+        { "BarterMenu", true },
+        { "Book Menu", true },
+        { "Console", true },
+        { "Native UI Menu", true },
+        { "ContainerMenu", true },
+        { "Dialogue Menu", true },
+        { "Crafting Menu", true },
+        { "Credits Menu", true },
+        { "Cursor Menu", false },
+        { "Debug Text Menu", true },
+        { "Fader Menu", false },
+        { "FavoritesMenu", true },
+        { "GiftMenu", true },
+        { "HUD Menu", false },
+        { "InventoryMenu", true },
+        { "Journal Menu", true },
+        { "Kinect Menu", true },
+        { "Loading Menu", true },
+        { "Lockpicking Menu", true },
+        { "MagicMenu", true },
+        { "Main Menu", true },
+        { "MapMarkerText3D", true },
+        { "MapMenu", true },
+        { "MessageBoxMenu", true },
+        { "Mist Menu", true },
+        { "Overlay Interaction Menu", false },
+        { "Overlay Menu", false },
+        { "Quantity Menu", true },
+        { "RaceSex Menu", true },
+        { "Sleep/Wait Menu", true },
+        { "StatsMenu", false },
+        { "StatsMenuPerks", true },
+        { "StatsMenuSkillRing", true },
+        { "TitleSequence Menu", false },
+        { "Top Menu", false },
+        { "Training Menu", true },
+        { "Tutorial Menu", true },
+        { "TweenMenu", true },
+        { "WSEnemyMeters", false },
+        { "WSDebugOverlay", false },
+        { "WSActivateRollover", false },
+        { "LoadWaitSpinner", false }
+    };
+    constexpr int numMenus = int(std::size(menus));
+    static_assert(numMenus <= 64, "Open menus are tracked in a 64-bit mask");
+
+    constexpr UInt64 gameStoppingMenuMask = [] {
+        UInt64 mask = 0;
+        for (int i = 0; i < numMenus; i++) {
+            if (menus[i].stopsGame) mask |= 1ULL << i;
+        }
+        return mask;
+    }();
+
+    // Bit n is set while menus[n] is open. Only written from menu events.
+    extern std::atomic<UInt64> openMenus;
+    extern std::atomic<int> numOpenMenus;
+
+    // Interns the menu names. Must be called before the event handler is registered.
+    void Init();
+
+    // Returns -1 if the menu isn't tracked
+    int GetMenuID(const BSFixedString &menuName);
 
-    extern std::unordered_map<std::string, bool> menuTypes;
+    // Safe to call from any thread
+    inline bool isGameStopped() { return (openMenus.load(std::memory_order_acquire) & gameStoppingMenuMask) != 0; }
+    inline bool isMenuOpen(int menuID) { return menuID >= 0 && (openMenus.load(std::memory_order_acquire) & (1ULL << menuID)) != 0; }
 
-    bool isGameStopped();
-    
     class AllMenuEventHandler : public BSTEventSink <MenuOpenCloseEvent> {
     public:
         virtual EventResult	ReceiveEvent(MenuOpenCloseEvent * evn, EventDispatcher<MenuOpenCloseEvent> * dispatcher);
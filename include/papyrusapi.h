@@ -62,6 +62,21 @@ namespace PapyrusAPI
         BSFixedString	eventName;
     };
 
+    // Layout of the array returned by HiggsVR.GetHandState. Bools are 0 or 1, state is a HiggsPluginAPI::IHiggsInterface002::HandState.
+    enum HandStateField
+    {
+        kHandState_State,
+        kHandState_IsHoldingObject,
+        kHandState_CanGrabObject,
+        kHandState_IsInGrabbableState,
+        kHandState_IsDisabled,
+        kHandState_IsWeaponCollisionDisabled,
+        kHandState_IsTwoHanding,
+        kHandState_IsHeldObjectColliding,
+        kHandState_FingerValues, // 5 values, thumb to pinky
+        kHandState_Count = kHandState_FingerValues + 5
+    };
+
     bool RegisterPapyrusFuncs(VMClassRegistry* registry);
 
     void OnPullEvent(TESObjectREFR *refr, bool isLeft);
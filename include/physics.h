@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "RE/havok.h"
+#include "deadline_scheduler.h"
 
 #include <Physics/Collide/Shape/Query/hkpRayHitCollector.h>
 #include <Physics/Collide/Shape/Query/hkpShapeRayCastCollectorOutput.h>
@@ -121,6 +122,8 @@ struct IslandDeactivationListener : public hkpIslandActivationListener
     void islandActivatedCallback(hkpSimulationIsland* island) override;
     void islandDeactivatedCallback(hkpSimulationIsland* island) override;
 };
+// Gets shadows updated if anything near the player went to sleep since the last call. Called once per frame from the main thread.
+void ShadowUpdateFix_ProcessDeactivatedIslands();
 
 struct HeldObjectCollisionListener : hkpContactListener
 {
@@ -183,10 +186,10 @@ struct PhysicsListener : public hkpContactListener, hkpWorldPostSimulationListen
 
     struct IgnoreContactPointData {
         hkpRigidBody *body;
-        double startTime;
-        double ignoreTime;
+        double endTime;
     };
     std::unordered_map<hkpRigidBody *, IgnoreContactPointData> ignoreContactPointData{};
+    DeadlineScheduler<hkpRigidBody *> ignoreContactPointExpiry{};
 };
 extern PhysicsListener g_physicsListener;
 
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "RE/havok.h"
+
+
+// Picks how many physics steps to split each frame into, and the max step time for complex scenes, based on how long steps have actually been taking.
+// Only used if Config::options.enableAdaptivePhysicsSteps is set, otherwise the frame is split purely based on minPhysicsFrameRate.
+namespace PhysicsStepScheduler {
+    struct Decision
+    {
+        int numSteps = 1;
+        int numStepsComplex = 1;
+        float maxStepTime = 0.f;
+        float maxStepTimeComplex = 0.f;
+        float predictedStepCostMs = 0.f;
+    };
+
+    // Called from the physics times update at the start of each frame. Sets fMaxTime and fMaxTimeComplex.
+    void ScheduleFrame(float frameTime);
+
+    // Called around every physics step, with how long the step took and the load it was done under
+    void RecordStep(double stepTimeMs, int numActiveConstraints);
+
+    int CountActiveConstraints(hkpWorld *world);
+
+    const Decision & GetLastDecision();
+}
@@ -7,15 +7,15 @@
 #include "skse64/PluginAPI.h"
 #include "skse64/GameReferences.h"
 
-#include "higgsinterface001.h"
+#include "higgsinterface002.h"
 
 
 namespace HiggsPluginAPI {
     // Handles skse mod messages requesting to fetch API functions from HIGGS
     void ModMessageHandler(SKSEMessagingInterface::Message * message);
 
-    // This object provides access to HIGGS's mod support API version 1
-    struct HiggsInterface001 : IHiggsInterface001
+    // This object provides access to HIGGS's mod support API. It implements every revision, as each one only adds to the previous.
+    struct HiggsInterface001 : IHiggsInterface002
     {
         virtual unsigned int GetBuildNumber();
 
@@ -74,6 +74,12 @@ namespace HiggsPluginAPI {
         virtual NiTransform GetGrabTransform(bool isLeft);
         virtual void SetGrabTransform(bool isLeft, const NiTransform &transform);
 
+        virtual int GetNumProfilerZones();
+        virtual bool GetProfilerZoneStats(int zoneIndex, ProfilerZoneStats &statsOut);
+
+        virtual const StateSnapshotBuffer * GetStateSnapshotBuffer();
+        virtual bool GetStateSnapshot(StateSnapshot &snapshotOut);
+
 
         std::mutex addCallbackLock;
         std::vector<PulledCallback> pulledCallbacks;
@@ -102,8 +108,13 @@ namespace HiggsPluginAPI {
         UInt64 higgsLayerBitfield = 0x01053343161b7fff;
 
         bool forceEnableWeaponCollision[2]{ false, false };
+
+        StateSnapshotBuffer stateSnapshotBuffer{};
     };
 
+    // Publishes the state of both hands to the snapshot buffer. Called once per frame after the hands have updated.
+    void PublishStateSnapshot();
+
     void TriggerPulledCallbacks(bool isLeft, TESObjectREFR *pulledRefr);
     void TriggerGrabbedCallbacks(bool isLeft, TESObjectREFR *grabbedRefr);
     void TriggerDroppedCallbacks(bool isLeft, TESObjectREFR *droppedRefr);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+
+#include "skse64/NiTypes.h"
+
+
+struct PoseSample
+{
+    double time; // GetTime() when the pose was received
+    NiPoint3 linearVelocity; // skyrim worldspace, m/s
+    NiPoint3 angularVelocity; // skyrim worldspace, rad/s
+};
+
+// History of timestamped controller poses, written from WaitPosesCB.
+// There must only be one writer, but it can be read from any thread without locking: each slot is guarded by a sequence counter and readers discard any sample that was overwritten while they were copying it.
+struct PoseHistory
+{
+    static constexpr int capacity = 128;
+
+    void Push(const PoseSample &sample);
+
+    // Copies the samples from the last windowTime seconds (relative to the newest sample) into out, newest first. Returns the number of samples copied.
+    int GetRecentSamples(double windowTime, PoseSample *out, int maxSamples) const;
+
+    // Least-squares fit of a line through the velocities of the last windowTime seconds of samples, evaluated at the newest sample.
+    // Since the window is in time rather than in samples, the result doesn't depend on the framerate the way averaging the last n frames does.
+    bool EstimateVelocity(double windowTime, NiPoint3 &linearVelocityOut, NiPoint3 &angularVelocityOut) const;
+
+private:
+    struct Slot
+    {
+        std::atomic<UInt32> sequence = 0; // odd while the slot is being written
+        PoseSample sample{};
+    };
+
+    Slot slots[capacity]{};
+    std::atomic<UInt64> writeCount = 0;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "skse64/NiTypes.h"
+
+#include "config.h"
+
+// Set to 0 to compile all profiling zones out entirely
+#ifndef HIGGS_PROFILING
+#define HIGGS_PROFILING 1
+#endif
+
+
+namespace Profiler {
+    // A named section of code to time. Zones register themselves the first time they are entered and live forever.
+    constexpr UInt16 kInvalidZoneId = 0xFFFF; // given to zones past the maximum number of zones, which are not recorded
+
+    struct Zone
+    {
+        Zone(const char *name);
+
+        const char *name;
+        UInt16 id;
+    };
+
+    UInt64 Now(); // in performance counter ticks
+    void Record(UInt16 zoneId, UInt64 start, UInt64 end, UInt16 depth);
+
+    extern thread_local UInt16 t_depth;
+
+    // Times the enclosing block. When profiling is turned off in the config, this costs a bool check and nothing else.
+    struct Scope
+    {
+        Scope(const Zone &zone) : zoneId(zone.id), isActive(Config::options.enableProfiler && zone.id != kInvalidZoneId)
+        {
+            if (isActive) {
+                depth = t_depth++;
+                start = Now();
+            }
+        }
+
+        ~Scope()
+        {
+            if (isActive) {
+                Record(zoneId, start, Now(), depth);
+                --t_depth;
+            }
+        }
+
+        UInt64 start;
+        UInt16 zoneId;
+        UInt16 depth;
+        bool isActive;
+    };
+
+    struct ZoneStats
+    {
+        const char *name;
+        UInt32 numSamples; // number of samples in the rolling window
+        float minMs;
+        float avgMs;
+        float p99Ms;
+        float maxMs;
+    };
+
+    // Moves the events recorded by every thread since the last call into the per-zone stats (and the trace capture, if one is in progress).
+    // Called once per frame from the main thread.
+    void CollectFrame();
+
+    int GetNumZones();
+    bool GetZoneStats(int zoneIndex, ZoneStats &statsOut);
+
+    // Records every event of the next numFrames frames, then writes them out as a chrome://tracing json file
+    void StartTraceCapture(int numFrames, const char *filename = "higgs_trace.json");
+}
+
+#if HIGGS_PROFILING
+#define HIGGS_PROFILE_CONCAT_INNER(a, b) a##b
+#define HIGGS_PROFILE_CONCAT(a, b) HIGGS_PROFILE_CONCAT_INNER(a, b)
+#define HIGGS_PROFILE_ZONE(name) \
+    static Profiler::Zone HIGGS_PROFILE_CONCAT(profilerZone, __LINE__)(name); \
+    Profiler::Scope HIGGS_PROFILE_CONCAT(profilerScope, __LINE__)(HIGGS_PROFILE_CONCAT(profilerZone, __LINE__))
+#else
+#define HIGGS_PROFILE_ZONE(name)
+#endif
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+
+#include "skse64/NiTypes.h"
+
+#include "math_utils.h"
+
+
+// Fixed-capacity history of values, newest first. Never allocates after construction.
+// The active length can be changed at runtime up to Capacity, and the sum of the active values is kept up to date as values are pushed.
+template <class T, int Capacity>
+struct RingBuffer
+{
+    RingBuffer(int length = Capacity, const T &value = T()) { Reset(length, value); }
+
+    // Sets the active length and fills the whole history with the given value
+    void Reset(int newLength, const T &value = T())
+    {
+        length = std::clamp(newLength, 1, Capacity);
+        head = 0;
+        std::fill(std::begin(values), std::end(values), value);
+        Resync();
+    }
+
+    // Same as Reset, but is a no-op if the length is not changing
+    void SetLength(int newLength, const T &value = T())
+    {
+        if (std::clamp(newLength, 1, Capacity) != length) {
+            Reset(newLength, value);
+        }
+    }
+
+    void Fill(const T &value) { Reset(length, value); }
+
+    // Pushes the newest value, dropping the oldest
+    void Push(const T &value)
+    {
+        head = head == 0 ? length - 1 : head - 1;
+        T &slot = values[head];
+        sum = sum - slot + value;
+        slot = value;
+
+        if (head == 0) {
+            // Recompute the sum from scratch once per wraparound so that floating point error can't accumulate
+            Resync();
+        }
+    }
+
+    // 0 is the newest value, size() - 1 is the oldest
+    const T & operator[](int i) const { return values[(head + i) % length]; }
+    int size() const { return length; }
+
+    const T & Sum() const { return sum; }
+    T Average() const { return sum / float(length); }
+
+    void Resync()
+    {
+        sum = T();
+        for (int i = 0; i < length; i++) {
+            sum = sum + values[i];
+        }
+    }
+
+    T values[Capacity];
+    T sum{};
+    int head = 0; // index of the newest value
+    int length = Capacity;
+};
+
+
+// History of velocities, newest first. Keeps running sums of the velocities and of their magnitudes, as well as a running max of the magnitudes,
+// so that the average velocity / speed and the peak velocity are all O(1) regardless of the history length.
+template <int Capacity>
+struct VelocityHistory
+{
+    VelocityHistory(int length = Capacity) { Reset(length); }
+
+    void Reset(int newLength)
+    {
+        velocities.Reset(newLength, NiPoint3());
+        speeds.Reset(newLength, 0.f);
+        pushCount = 0;
+        maxQueueFront = maxQueueBack = 0;
+        PushMaxCandidate(0.f);
+    }
+
+    void SetLength(int newLength)
+    {
+        if (std::clamp(newLength, 1, Capacity) != velocities.size()) {
+            Reset(newLength);
+        }
+    }
+
+    void Push(const NiPoint3 &velocity)
+    {
+        float speed = VectorLength(velocity);
+        velocities.Push(velocity);
+        speeds.Push(speed);
+        ++pushCount;
+        PushMaxCandidate(speed);
+    }
+
+    // 0 is the newest value, size() - 1 is the oldest
+    const NiPoint3 & operator[](int i) const { return velocities[i]; }
+    int size() const { return velocities.size(); }
+
+    NiPoint3 AverageVelocity() const { return velocities.Average(); }
+    float AverageSpeed() const { return speeds.Average(); }
+
+    // Index (0 = newest) of the velocity with the largest magnitude. Ties go to the newest value.
+    int MaxSpeedIndex() const
+    {
+        return int(pushCount - maxQueue[maxQueueFront % Capacity].pushIndex);
+    }
+
+    // The peak velocity, averaged with its neighbours to smooth out noise
+    NiPoint3 GetMaxVelocity() const
+    {
+        int largestIndex = MaxSpeedIndex();
+        if (largestIndex == 0) {
+            // Max is the first value
+            return velocities[0];
+        }
+        else if (largestIndex == size() - 1) {
+            // Max is the last value
+            return velocities[largestIndex];
+        }
+        else {
+            // Regular case - avg 3 values centered at the peak
+            return (velocities[largestIndex - 1] + velocities[largestIndex] + velocities[largestIndex + 1]) / 3;
+        }
+    }
+
+    RingBuffer<NiPoint3, Capacity> velocities{};
+    RingBuffer<float, Capacity> speeds{};
+
+private:
+    struct MaxCandidate
+    {
+        UInt64 pushIndex;
+        float speed;
+    };
+
+    // Monotonic queue of the speeds that could still become the max of the window: decreasing speed from front to back.
+    // Every value is added and removed at most once, so maintaining it is amortized O(1) per push.
+    void PushMaxCandidate(float speed)
+    {
+        // Values older than the window can never be the max again
+        UInt64 oldestIndex = pushCount >= UInt64(size()) ? pushCount - size() + 1 : 0;
+        while (maxQueueFront != maxQueueBack && maxQueue[maxQueueFront % Capacity].pushIndex < oldestIndex) {
+            ++maxQueueFront;
+        }
+
+        // Older values that are no faster than this one can never be the max again either
+        while (maxQueueFront != maxQueueBack && maxQueue[(maxQueueBack - 1) % Capacity].speed <= speed) {
+            --maxQueueBack;
+        }
+
+        maxQueue[maxQueueBack % Capacity] = { pushCount, speed };
+        ++maxQueueBack;
+    }
+
+    MaxCandidate maxQueue[Capacity]{};
+    UInt64 maxQueueFront = 0;
+    UInt64 maxQueueBack = 0;
+    UInt64 pushCount = 0;
+};
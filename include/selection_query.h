@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "RE/havok.h"
+
+#include "skse64/GameReferences.h"
+
+struct Hand;
+
+
+// One hit from a selection cast. Everything that doesn't depend on the state of the hands is resolved while the world is still locked,
+// so that each hand can filter the candidates afterwards without locking the world again.
+struct SelectionCandidate
+{
+    hkpCollidable *collidable; // only for comparisons
+    NiPointer<bhkRigidBody> rigidBody;
+    NiPointer<TESObjectREFR> ref; // null if the collidable does not belong to a reference
+    hkVector4 point;
+    UInt32 filterInfo;
+    bool isSelectable; // IsObjectSelectable()
+    bool isProjectileInFlight;
+};
+
+// Candidates from one selection cast, along with what they were cast with, so that a hand can check they're still valid for its current pose
+struct SelectionCastResult
+{
+    bool IsFor(const NiPoint3 &start, const NiPoint3 &direction) const;
+
+    std::vector<SelectionCandidate> candidates{};
+    NiPoint3 castStart;
+    NiPoint3 castDirection;
+    double castTime = -1; // g_currentFrameTime when the cast was done
+};
+
+struct HandSelectionQueries
+{
+    SelectionCastResult nearCast{};
+    SelectionCastResult farCast{};
+    hkpCollidable *widePullTarget = nullptr; // the pulled object's collidable, if it was found by the wide radius check during the near cast
+
+    // What the far cast's candidates were last actually swept with. While the hand stays close to this, the candidates are reused instead of sweeping again.
+    NiPoint3 farSweepStart;
+    NiPoint3 farSweepDirection;
+    double farSweepTime = -1;
+    int farSweepNumActiveIslands = -1;
+};
+
+struct SelectionCastStats
+{
+    UInt64 numFarSweeps = 0;
+    UInt64 numFarSweepsSkipped = 0; // far casts that reused the previous sweep's candidates
+};
+extern SelectionCastStats g_selectionCastStats;
+
+// The selection casts. These are done with dedicated query bodies that are never added to the world, so the game's pick sphere is left alone.
+// The caller must hold the world's read lock.
+void CastSelectionNear(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, bhkRigidBody *pulledBody, HandSelectionQueries &queries);
+// The far cast reuses the candidates of its last sweep if the hand has barely moved since, nothing in the world has (de)activated, and the candidates are all still in the world as the same references, see Config::options.farCastCoherence*.
+void CastSelectionFar(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, UInt16 playerCollisionGroup, HandSelectionQueries &queries);
+bool CastSelectionNearAgainst(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, hkpCollidable *target, hkVector4 &hitPoint);
+
+// Does the selection casts for both hands ahead of their updates, under a single read lock of the world. Hands that end up casting with a different pose than expected just redo their own casts.
+void RunSelectionQueries(bhkWorld *world, Hand &rightHand, Hand &leftHand);
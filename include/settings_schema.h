@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <string_view>
+
+#include "config.h"
+
+
+namespace Config {
+    enum class SettingType : UInt8
+    {
+        Float,
+        Double,
+        Int,
+        Bool
+    };
+
+    // A numeric setting that is read from the ini and can be read / written by name at runtime. Its default is whatever Options initializes the field to.
+    struct SettingInfo
+    {
+        static constexpr double unbounded = std::numeric_limits<double>::infinity();
+
+        constexpr SettingInfo(std::string_view name, float Options::*member, bool isImportant = true, double minValue = -unbounded, double maxValue = unbounded) :
+            name(name), type(SettingType::Float), isImportant(isImportant), minValue(minValue), maxValue(maxValue), floatMember(member) {}
+        constexpr SettingInfo(std::string_view name, double Options::*member, bool isImportant = true, double minValue = -unbounded, double maxValue = unbounded) :
+            name(name), type(SettingType::Double), isImportant(isImportant), minValue(minValue), maxValue(maxValue), doubleMember(member) {}
+        constexpr SettingInfo(std::string_view name, int Options::*member, bool isImportant = true, double minValue = -unbounded, double maxValue = unbounded) :
+            name(name), type(SettingType::Int), isImportant(isImportant), minValue(minValue), maxValue(maxValue), intMember(member) {}
+        constexpr SettingInfo(std::string_view name, bool Options::*member, bool isImportant = true) :
+            name(name), type(SettingType::Bool), isImportant(isImportant), minValue(0), maxValue(1), boolMember(member) {}
+
+        double Get(const Options &opts) const
+        {
+            switch (type) {
+            case SettingType::Float: return double(opts.*floatMember);
+            case SettingType::Double: return opts.*doubleMember;
+            case SettingType::Int: return double(opts.*intMember);
+            default: return double(opts.*boolMember);
+            }
+        }
+
+        // The value is clamped to the setting's bounds
+        void Set(Options &opts, double val) const
+        {
+            val = std::clamp(val, minValue, maxValue);
+            switch (type) {
+            case SettingType::Float: opts.*floatMember = float(val); break;
+            case SettingType::Double: opts.*doubleMember = val; break;
+            case SettingType::Int: opts.*intMember = int(val); break;
+            default: opts.*boolMember = bool(val); break;
+            }
+        }
+
+        std::string_view name;
+        SettingType type;
+        bool isImportant; // whether it not being in the ini is worth a warning
+        double minValue;
+        double maxValue;
+        union
+        {
+            float Options::*floatMember;
+            double Options::*doubleMember;
+            int Options::*intMember;
+            bool Options::*boolMember;
+        };
+    };
+
+    // All numeric settings, in the order they are read from the ini. Anything that isn't a plain number (vectors, strings, maps) is read separately in ReadConfigOptions.
+    inline constexpr SettingInfo g_settings[] = {
+        { "debugDrawControllers", &Options::debugDrawControllers },
+
+        { "spoofProjectileWeaponHitsAsIfBlocked", &Options::spoofProjectileWeaponHitsAsIfBlocked },
+
+        { "HandCollisionBoxRadius", &Options::handCollisionBoxRadius },
+
+        { "HandCollisionBoxRadiusBeast", &Options::handCollisionBoxRadiusBeast },
+
+        { "RightShoulderRadius", &Options::rightShoulderRadius },
+
+        { "LeftShoulderRadius", &Options::leftShoulderRadius },
+
+        { "MouthRadius", &Options::mouthRadius },
+
+        { "FarCastRadius", &Options::farCastRadius },
+        { "FarCastDistance", &Options::farCastDistance },
+
+        { "NearCastRadius", &Options::nearCastRadius },
+        { "NearCastDistance", &Options::nearCastDistance },
+
+        { "WidePullGrabRadius", &Options::widePullGrabRadius },
+
+        { "NearbyGrabBodyRadius", &Options::nearbyGrabBodyRadius },
+
+        { "farCastCoherenceMaxAge", &Options::farCastCoherenceMaxAge },
+        { "farCastCoherenceMaxDistance", &Options::farCastCoherenceMaxDistance },
+        { "farCastCoherenceMaxAngle", &Options::farCastCoherenceMaxAngle },
+
+        { "SelectedFadeTime", &Options::selectedLeewayTime },
+        { "TriggerPreemptTime", &Options::triggerPressedLeewayTime },
+        { "InputLeewayTime", &Options::inputLeewayTime },
+        { "ForceInputTime", &Options::forceInputTime },
+        { "PullApplyVelocityTime", &Options::pullApplyVelocityTime },
+        { "PullTrackHandTime", &Options::pullTrackHandTime },
+        { "LootSpawnInTime", &Options::lootSpawnInTime },
+        { "GrabFreezeNearbyVelocityTime", &Options::grabFreezeNearbyVelocityTime },
+        { "PullHapticFadeTime", &Options::pullHapticFadeTime },
+        { "GrabHapticFadeTime", &Options::grabHapticFadeTime },
+        { "GrabStartMaxTime", &Options::grabStartMaxTime },
+        { "ShoulderDropHapticFadeTime", &Options::shoulderDropHapticFadeTime },
+        { "MouthDropHapticFadeTime", &Options::mouthDropHapticFadeTime },
+        { "RolloverHideTime", &Options::rolloverHideTime },
+        { "physicsGrabIgnoreHandDistanceTime", &Options::physicsGrabIgnoreHandDistanceTime },
+
+        { "FingerAnimateEndTime", &Options::fingerAnimateEndTime },
+        { "FingerAnimateEndDoubleSpeedTime", &Options::fingerAnimateEndDoubleSpeedTime },
+        { "AfterDropFingerAnimateTime", &Options::afterDropFingerAnimateTime },
+        { "FingerAnimateStartDoubleSpeedTime", &Options::fingerAnimateStartDoubleSpeedTime },
+        { "FingerAnimateGrabDoubleSpeedTime", &Options::fingerAnimateGrabDoubleSpeedTime },
+        { "WeaponCollisionDisableOnHitTime", &Options::weaponCollisionDisableOnHitTime },
+        { "WeaponCollisionDisableOnHitDelay", &Options::weaponCollisionDisableOnHitDelay },
+        { "TriggerGripIconSwitchTime", &Options::triggerGripIconSwitchTime },
+
+        { "RolloverAfterGrabAlphaFadeInTime", &Options::rolloverAfterGrabAlphaFadeInTime },
+        { "RolloverAfterDropAlphaFadeInTime", &Options::rolloverAfterDropAlphaFadeInTime },
+
+        { "LogLevelSelection", &Options::logLevelSelection, false, -1, IDebugLog::kLevel_DebugMessage },
+        { "LogLevelGrab", &Options::logLevelGrab, false, -1, IDebugLog::kLevel_DebugMessage },
+        { "LogLevelGeometry", &Options::logLevelGeometry, false, -1, IDebugLog::kLevel_DebugMessage },
+        { "LogLevelFingers", &Options::logLevelFingers, false, -1, IDebugLog::kLevel_DebugMessage },
+        { "LogLevelPhysics", &Options::logLevelPhysics, false, -1, IDebugLog::kLevel_DebugMessage },
+
+        { "enableProfiler", &Options::enableProfiler },
+        { "profilerTraceFrames", &Options::profilerTraceFrames, false }, // optional, mostly meant to be set at runtime
+
+        { "GrabStartSpeed", &Options::grabStartSpeed },
+        { "GrabStartAngularSpeed", &Options::grabStartAngularSpeed },
+
+        { "PullSpeedThreshold", &Options::pullSpeedThreshold },
+        { "lootSpeedThreshold", &Options::lootSpeedThreshold },
+        { "lootToGrabSpeedThreshold", &Options::lootToGrabSpeedThreshold },
+        { "lootToGrabLeewayTime", &Options::lootToGrabLeewayTime },
+
+        { "RolloverScale", &Options::rolloverScale },
+
+        { "ThrowVelocityThreshold", &Options::throwVelocityThreshold },
+        { "ThrowVelocityBoostFactor", &Options::throwVelocityBoostFactor },
+        { "throwIgnoreHandCollisionTime", &Options::throwIgnoreHandCollisionTime },
+        { "velocityHistoryLength", &Options::velocityHistoryLength },
+        { "throwVelocityEstimationWindow", &Options::throwVelocityEstimationWindow },
+
+        { "ShoulderVelocityThreshold", &Options::shoulderVelocityThreshold },
+        { "MouthVelocityThreshold", &Options::mouthVelocityThreshold },
+
+        { "PullDestinationZOffset", &Options::pullDestinationZOffset },
+        { "PulledAngularDamping", &Options::pulledAngularDamping },
+        { "PulledGrabHandAdjustDistance", &Options::pulledGrabHandAdjustDistance },
+        { "AngularVelocityMultiplier", &Options::angularVelocityMultiplier },
+        { "TangentialVelocityLimit", &Options::tangentialVelocityLimit },
+        { "TwoHandedRotationSnapSpeed", &Options::twoHandedRotationSnapSpeed },
+
+        { "enableWeaponTwoHanding", &Options::enableWeaponTwoHanding },
+        { "offhandAffectsTwoHandedRotation", &Options::offhandAffectsTwoHandedRotation },
+        { "twoHandedHandToHandAlignmentFactor", &Options::twoHandedHandToHandAlignmentFactor },
+        { "twoHandedHandToHandShiftFactor", &Options::twoHandedHandToHandShiftFactor },
+        { "twoHandedHandToHandRotationFactor", &Options::twoHandedHandToHandRotationFactor },
+
+        { "offhandAffectsTwoHandedRotationCrossbow", &Options::offhandAffectsTwoHandedRotationCrossbow },
+        { "twoHandedHandToHandAlignmentFactorCrossbow", &Options::twoHandedHandToHandAlignmentFactorCrossbow },
+        { "twoHandedHandToHandShiftFactorCrossbow", &Options::twoHandedHandToHandShiftFactorCrossbow },
+        { "twoHandedHandToHandRotationFactorCrossbow", &Options::twoHandedHandToHandRotationFactorCrossbow },
+
+        { "SelectedCloseFingerAnimMaxHandSpeed", &Options::selectedCloseFingerAnimMaxHandSpeed },
+        { "SelectedCloseFingerAnimValue", &Options::selectedCloseFingerAnimValue },
+        { "FingerAnimateGrabLinearSpeed", &Options::fingerAnimateGrabLinearSpeed },
+        { "FingerAnimateGrabAngularSpeed", &Options::fingerAnimateGrabAngularSpeed },
+        { "FingerAnimateStartLinearSpeed", &Options::fingerAnimateStartLinearSpeed },
+        { "FingerAnimateStartAngularSpeed", &Options::fingerAnimateStartAngularSpeed },
+        { "FingerAnimateEndLinearSpeed", &Options::fingerAnimateEndLinearSpeed },
+        { "FingerAnimateEndAngularSpeed", &Options::fingerAnimateEndAngularSpeed },
+
+        { "SelectionLockedStartHapticStrength", &Options::selectionLockedStartHapticStrength },
+        { "SelectionLockedStartHapticDuration", &Options::selectionLockedStartHapticDuration },
+        { "SelectionLockedEndHapticStrength", &Options::selectionLockedEndHapticStrength },
+        { "SelectionLockedEndHapticDuration", &Options::selectionLockedEndHapticDuration },
+        { "SelectionLockedBaseHapticStrength", &Options::selectionLockedBaseHapticStrength },
+        { "SelectionLockedProportionalHapticStrength", &Options::selectionLockedProportionalHapticStrength },
+
+        { "GrabBaseHapticStrength", &Options::grabBaseHapticStrength },
+        { "GrabProportionalHapticStrength", &Options::grabProportionalHapticStrength },
+        { "GrabHapticMassExponent", &Options::grabHapticMassExponent },
+
+        { "CollisionMaxInitialContactPointDistance", &Options::collisionMaxInitialContactPointDistance },
+        { "CollisionMinHapticSpeed", &Options::collisionMinHapticSpeed },
+        { "CollisionBaseHapticStrength", &Options::collisionBaseHapticStrength },
+        { "CollisionMassProportionalHapticStrength", &Options::collisionMassProportionalHapticStrength },
+        { "CollisionSpeedProportionalHapticStrength", &Options::collisionSpeedProportionalHapticStrength },
+        { "CollisionHapticMassExponent", &Options::collisionHapticMassExponent },
+        { "CollisionHapticDuration", &Options::collisionHapticDuration },
+
+        { "ShoulderConstantHapticStrength", &Options::shoulderConstantHapticStrength },
+        { "ShoulderDropHapticStrength", &Options::shoulderDropHapticStrength },
+
+        { "MouthConstantHapticStrength", &Options::mouthConstantHapticStrength },
+        { "MouthDropHapticStrength", &Options::mouthDropHapticStrength },
+
+        { "NearbyGrabLinearDamping", &Options::nearbyGrabLinearDamping },
+        { "NearbyGrabAngularDamping", &Options::nearbyGrabAngularDamping },
+
+        { "NearbyGrabMaxLinearVelocity", &Options::nearbyGrabMaxLinearVelocity },
+        { "NearbyGrabMaxAngularVelocity", &Options::nearbyGrabMaxAngularVelocity },
+
+        { "PullDurationA", &Options::pullDurationA },
+        { "PullDurationB", &Options::pullDurationB },
+        { "PullDurationC", &Options::pullDurationC },
+
+        { "MaxHandDistance", &Options::maxHandDistance },
+        { "DampedCollisionHapticStrengthMultiplier", &Options::dampedCollisionHapticStrengthMultiplier },
+
+        { "RolloverMinAlphaToShow", &Options::rolloverMinAlphaToShow },
+        { "RolloverAlphaLogisticK", &Options::rolloverAlphaLogisticK },
+        { "RolloverAlphaLogisticMidpoint", &Options::rolloverAlphaLogisticMidpoint },
+        { "RolloverAlphaFadeInLogisticK", &Options::rolloverAlphaFadeInLogisticK },
+        { "RolloverAlphaFadeInLogisticMidpoint", &Options::rolloverAlphaFadeInLogisticMidpoint },
+
+        { "GeometryVertexAlphaThreshold", &Options::geometryVertexAlphaThreshold },
+
+        { "GrabLateralWeight", &Options::grabLateralWeight },
+        { "GrabDirectionalWeight", &Options::grabDirectionalWeight },
+        { "grabMaxTriangleDistance", &Options::grabMaxTriangleDistance },
+
+        { "UseLoudSoundGrab", &Options::useLoudSoundGrab },
+        { "UseLoudSoundDrop", &Options::useLoudSoundDrop },
+        { "UseLoudSoundPull", &Options::useLoudSoundPull },
+
+        { "EnableWeaponCollision", &Options::enableWeaponCollision },
+        { "ForcePhysicsGrab", &Options::forcePhysicsGrab },
+        { "DisableGrabHairGeometry", &Options::disableGrabHair },
+        { "DisableGrabGeometryWithVertexAlpha", &Options::disableGrabGeometryWithVertexAlpha },
+        { "InheritTangentialVelocity", &Options::inheritTangentialVelocity },
+
+        { "useVrikWeaponTransform", &Options::useVrikWeaponTransform },
+        { "weaponCollisionScale", &Options::weaponCollisionScale },
+
+        { "slowMovementWhenObjectIsHeld", &Options::slowMovementWhenObjectIsHeld },
+        { "slowMovementMassProportion", &Options::slowMovementMassProportion },
+        { "slowMovementMassExponent", &Options::slowMovementMassExponent },
+        { "slowMovementMaxReduction", &Options::slowMovementMaxReduction },
+        { "slowMovementFadeOutTime", &Options::slowMovementFadeOutTime },
+
+        { "jumpHeightMassProportion", &Options::jumpHeightMassProportion },
+        { "jumpHeightMassExponent", &Options::jumpHeightMassExponent },
+        { "jumpHeightMaxReduction", &Options::jumpHeightMaxReduction },
+
+        { "EnableHavokFix", &Options::enableHavokFix },
+        { "HavokMaxTimeComplexMultiplier", &Options::havokMaxTimeComplexMultiplier },
+        { "minPhysicsFrameRate", &Options::minPhysicsFrameRate },
+        { "maxNumPhysicsStepsPerUpdate", &Options::maxNumPhysicsStepsPerUpdate },
+        { "maxNumPhysicsStepsPerUpdateComplex", &Options::maxNumPhysicsStepsPerUpdateComplex },
+        { "enableAdaptivePhysicsSteps", &Options::enableAdaptivePhysicsSteps },
+        { "physicsStepBudgetMs", &Options::physicsStepBudgetMs, true, 0 },
+        { "physicsStepHysteresisFrames", &Options::physicsStepHysteresisFrames, true, 1 },
+        { "deterministicPhysicsSteps", &Options::deterministicPhysicsSteps },
+        { "deterministicPhysicsStepCostMs", &Options::deterministicPhysicsStepCostMs },
+
+        { "EnableShadowUpdateFix", &Options::enableShadowUpdateFix },
+        { "numShadowUpdates", &Options::numShadowUpdates },
+        { "MaxDistanceOfSimulationIslandToUpdate", &Options::maxDistanceOfSimulationIslandToUpdate },
+
+        { "forceGrabbedNodeUpdate", &Options::forceGrabbedNodeUpdate },
+
+        { "grabConstraintAngularTau", &Options::grabConstraintAngularTau },
+        { "grabConstraintAngularProportionalRecoveryVelocity", &Options::grabConstraintAngularProportionalRecoveryVelocity },
+        { "grabConstraintAngularConstantRecoveryVelocity", &Options::grabConstraintAngularConstantRecoveryVelocity },
+        { "grabConstraintAngularDamping", &Options::grabConstraintAngularDamping },
+
+        { "grabConstraintLinearTau", &Options::grabConstraintLinearTau },
+        { "grabConstraintLinearMaxForce", &Options::grabConstraintLinearMaxForce },
+        { "grabConstraintLinearMaxForceWeapon", &Options::grabConstraintLinearMaxForceWeapon },
+        { "grabConstraintLinearProportionalRecoveryVelocity", &Options::grabConstraintLinearProportionalRecoveryVelocity },
+        { "grabConstraintLinearConstantRecoveryVelocity", &Options::grabConstraintLinearConstantRecoveryVelocity },
+        { "grabConstraintLinearDamping", &Options::grabConstraintLinearDamping },
+
+        { "grabConstraintAngularTauBody", &Options::grabConstraintAngularTauBody },
+        { "grabConstraintAngularTauBodyStart", &Options::grabConstraintAngularTauBodyStart },
+        { "grabConstraintLinearTauBody", &Options::grabConstraintLinearTauBody },
+        { "grabConstraintLinearTauBodyStart", &Options::grabConstraintLinearTauBodyStart },
+
+        { "physicsGrabLerpTauTimeBody", &Options::physicsGrabLerpTauTimeBody },
+
+        { "grabConstraintAngularTauActor", &Options::grabConstraintAngularTauActor },
+        { "grabConstraintLinearTauActor", &Options::grabConstraintLinearTauActor },
+
+        { "grabConstraintCollidingAngularTau", &Options::grabConstraintCollidingAngularTau },
+        { "grabConstraintCollidingLinearTau", &Options::grabConstraintCollidingLinearTau },
+        { "grabConstraintTauLerpSpeed", &Options::grabConstraintTauLerpSpeed },
+
+        { "grabConstraintMaxForceToMassRatio", &Options::grabConstraintMaxForceToMassRatio },
+        { "grabConstraintAngularToLinearForceRatio", &Options::grabConstraintAngularToLinearForceRatio },
+
+        { "grabConstraintFadeInStartAngularMaxForceRatio", &Options::grabConstraintFadeInStartAngularMaxForceRatio },
+        { "grabConstraintFadeInTime", &Options::grabConstraintFadeInTime },
+
+        { "grabConstraintLinearMaxForceActor", &Options::grabConstraintLinearMaxForceActor },
+        { "grabConstraintAngularMaxForceActor", &Options::grabConstraintAngularMaxForceActor },
+
+        { "physicsGrabLerpHandTimeMin", &Options::physicsGrabLerpHandTimeMin },
+        { "physicsGrabLerpHandTimeMax", &Options::physicsGrabLerpHandTimeMax },
+        { "physicsGrabLerpHandMinDistance", &Options::physicsGrabLerpHandMinDistance },
+        { "physicsGrabLerpHandMaxDistance", &Options::physicsGrabLerpHandMaxDistance },
+
+        { "sneakUnsneakIgnoreHandDistanceTime", &Options::sneakUnsneakIgnoreHandDistanceTime },
+        { "handWeaponCollisionEnableDelay", &Options::handWeaponCollisionEnableDelay },
+
+        { "minCollideClutterMass", &Options::minCollideClutterMass },
+
+        { "enableTwoHandedGrabbing", &Options::enableTwoHandedGrabbing },
+        { "allowGrabWithSpell", &Options::allowGrabWithSpell },
+        { "restrictPullWithSpell", &Options::restrictPullWithSpell },
+
+        { "grabbedObjectMinInertia", &Options::grabbedObjectMinInertia },
+        { "grabbedObjectMaxInertiaRatio", &Options::grabbedObjectMaxInertiaRatio },
+
+        { "doPhysicsGrabPlayerMovementCompensation", &Options::doPhysicsGrabPlayerMovementCompensation },
+        { "playerSpaceMinDeltaAngleToWarp", &Options::playerSpaceMinDeltaAngleToWarp },
+        { "grabbedActorAffectedBoneRadius", &Options::grabbedActorAffectedBoneRadius },
+
+        { "droppedObjMinDetectionSpeed", &Options::droppedObjMinDetectionSpeed },
+        { "droppedObjDetectionMassSilent", &Options::droppedObjDetectionMassSilent },
+        { "droppedObjDetectionMassNormal", &Options::droppedObjDetectionMassNormal },
+        { "droppedObjDetectionMassLoud", &Options::droppedObjDetectionMassLoud },
+
+        { "droppedObjMinDestructibleSpeed", &Options::droppedObjMinDestructibleSpeed },
+        { "droppedObjDestructibleInflictedDamage", &Options::droppedObjDestructibleInflictedDamage },
+        { "droppedObjDestructibleSelfDamage", &Options::droppedObjDestructibleSelfDamage },
+
+        { "DisableShaders", &Options::disableShaders },
+        { "DisableSelectionBeam", &Options::disableSelectionBeam },
+        { "DisableLooting", &Options::disableLooting },
+        { "disableGravityGlovesLooting", &Options::disableGravityGlovesLooting },
+        { "disableGravityGlovesLootingLiveActors", &Options::disableGravityGlovesLootingLiveActors },
+        { "allowLootingNonRagdolledActors", &Options::allowLootingNonRagdolledActors },
+        { "allowLootingLiveActors", &Options::allowLootingLiveActors },
+        { "SkipActivateBooks", &Options::skipActivateBooks },
+        { "DisableRolloverRumble", &Options::disableRolloverRumble },
+        { "AlwaysShowHands", &Options::alwaysShowHands },
+        { "DisableVanillaGrab", &Options::disableVanillaGrab },
+        { "convertDebrisToMoving", &Options::convertDebrisToMoving },
+
+        { "treatHandCollisionAsBelongingToPlayer", &Options::treatHandCollisionAsBelongingToPlayer },
+        { "allowAllPlayerCollisionForTriggers", &Options::allowAllPlayerCollisionForTriggers },
+
+        { "AllowGrabWithEmptyArrowHand", &Options::allowGrabWithEmptyArrowHand },
+        { "AllowGrabWithTwoHandedOffhand", &Options::allowGrabWithTwoHandedOffhand },
+        { "allowDaggerTwoHanding", &Options::allowDaggerTwoHanding },
+        { "AllowTwoHandingWithSpellInOffhand", &Options::allowTwoHandingWithSpellInOffhand },
+        { "AllowGrabCurrentHorse", &Options::allowGrabCurrentHorse },
+
+        { "grabIgnoreBlood", &Options::grabIgnoreBlood },
+        { "grabIgnoreDecal", &Options::grabIgnoreDecal },
+        { "grabIgnoreSoftEffect", &Options::grabIgnoreSoftEffect },
+
+        { "EnableTrigger", &Options::enableTrigger },
+        { "EnableGrip", &Options::enableGrip },
+        { "GripInputMethod", &Options::gripInputMethod },
+        { "AllowGripPressWhileUsingTouchInput", &Options::allowGripPressWhileUsingTouchInput },
+
+        { "EnableDrinkPoison", &Options::enableDrinkPoison },
+        { "OverrideActivateText", &Options::overrideActivateText },
+        { "UseAttachPointForInitialGrab", &Options::useAttachPointForInitialGrab },
+
+        { "dontAnimateFingersWhenBeast", &Options::dontAnimateFingersWhenBeast },
+
+        { "doContainerPhysics", &Options::doContainerPhysics },
+
+        { "doDoublePrecision", &Options::doDoublePrecision },
+        { "handleVrikOffsetting", &Options::handleVrikOffsetting },
+
+        { "reloadConfigIfModified", &Options::reloadConfigIfModified },
+
+        { "enableHiggsGrabNodes", &Options::enableHiggsGrabNodes },
+        { "printHiggsGrabNodeInfo", &Options::printHiggsGrabNodeInfo },
+
+        { "DelayRightGripInput", &Options::delayRightGripInput },
+        { "DelayLeftGripInput", &Options::delayLeftGripInput },
+
+        { "dummyFloat0", &Options::dummyFloat0, false },
+        { "dummyFloat1", &Options::dummyFloat1, false },
+        { "dummyFloat2", &Options::dummyFloat2, false },
+        { "dummyFloat3", &Options::dummyFloat3, false },
+        { "dummyFloat4", &Options::dummyFloat4, false },
+
+        { "dummyInt0", &Options::dummyInt0, false },
+        { "dummyInt1", &Options::dummyInt1, false },
+        { "dummyInt2", &Options::dummyInt2, false },
+        { "dummyInt3", &Options::dummyInt3, false },
+        { "dummyInt4", &Options::dummyInt4, false },
+    };
+    inline constexpr size_t g_numSettings = std::size(g_settings);
+
+    // Indices into g_settings, sorted by name
+    inline constexpr std::array<UInt16, g_numSettings> g_settingsByName = [] {
+        std::array<UInt16, g_numSettings> indices{};
+        for (size_t i = 0; i < g_numSettings; i++) {
+            indices[i] = UInt16(i);
+        }
+        std::sort(indices.begin(), indices.end(), [](UInt16 a, UInt16 b) { return g_settings[a].name < g_settings[b].name; });
+        return indices;
+    }();
+
+    static_assert([] {
+        for (size_t i = 1; i < g_numSettings; i++) {
+            if (g_settings[g_settingsByName[i - 1]].name == g_settings[g_settingsByName[i]].name) return false;
+        }
+        return true;
+    }(), "Setting names must be unique");
+
+    // Returns null if there is no setting with that name. Names are case-sensitive. Folds to a constant when the name is known at compile time.
+    constexpr const SettingInfo * FindSetting(std::string_view name)
+    {
+        auto it = std::lower_bound(g_settingsByName.begin(), g_settingsByName.end(), name, [](UInt16 index, std::string_view n) { return g_settings[index].name < n; });
+        if (it == g_settingsByName.end() || g_settings[*it].name != name) return nullptr;
+        return &g_settings[*it];
+    }
+}
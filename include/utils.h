@@ -56,9 +56,47 @@ NiTransform GetLocalTransformForDesiredWorldTransform(NiAVObject *node, const Ni
 void UpdateNodeTransformLocal(NiAVObject *node, const NiTransform &worldTransform);
 void RecalculateNodeTransform(NiAVObject *node);
 NiTransform GetRigidBodyTLocalTransform(bhkRigidBody *rigidBody);
-void UpdateKeyframedNode(NiAVObject *node, NiTransform &transform);
 void UpdateBoneMatrices(NiAVObject *obj);
 
+struct SkinnedGeometry
+{
+    NiPointer<BSGeometry> geometry;
+    NiSkinInstance *skinInstance; // only for comparisons, to notice the geometry being re-skinned
+};
+struct SubtreeNode
+{
+    NiPointer<NiNode> node;
+    UInt16 numChildren; // to notice anything being attached to or detached from it
+};
+// Also collects every node it visits into nodesOut, root first, so that changes to the subtree can be noticed later with HasSubtreeChanged
+void CollectSkinnedGeometry(NiAVObject *obj, std::vector<SkinnedGeometry> &geometryOut, std::vector<SubtreeNode> *nodesOut = nullptr);
+// True if anything has been attached or detached anywhere under the nodes since they were collected
+bool HasSubtreeChanged(const std::vector<SubtreeNode> &nodes);
+// Returns false if any of the geometry has since been detached or re-skinned, in which case the list should be collected again
+bool UpdateBoneMatrices(const std::vector<SkinnedGeometry> &skinnedGeometry);
+
+// What UpdateKeyframedNode needs to know about a node. Worked out once when the node starts being keyframed instead of every frame.
+struct KeyframedNodeInfo
+{
+    bool IsFor(NiAVObject *node) const; // false if it's a different node, or the node's 3d has changed since
+
+    NiPointer<NiAVObject> node = nullptr;
+    bhkCollisionObject *collisionObject = nullptr; // only for comparisons
+    NiPointer<bhkRigidBody> rigidBody = nullptr;
+    bhkBlendCollisionObject *blendCollisionObject = nullptr;
+    bool isRigidBodyT = false;
+    NiTransform rigidBodyTLocalTransform{};
+    std::vector<SkinnedGeometry> skinnedGeometry{}; // all skinned geometry under the node
+    std::vector<SubtreeNode> subtreeNodes{}; // to notice skinned geometry being attached under the node after it was collected
+    bool isSkinnedGeometryStale = false;
+};
+void ClassifyKeyframedNode(NiAVObject *node, KeyframedNodeInfo &infoOut);
+
+// info must stay alive until FlushKeyframedNodes() is called
+void UpdateKeyframedNode(KeyframedNodeInfo &info, const NiTransform &transform);
+// Bone matrix and shadow updates of keyframed nodes are deferred until all of them have been moved for the frame, and then done in one pass, once per node
+void FlushKeyframedNodes();
+
 inline VRMeleeData * GetVRMeleeData(bool isLeft) { return (VRMeleeData *)((UInt64)*g_thePlayer + 0x710 + (isLeft ? sizeof(VRMeleeData) : 0)); };
 
 NiPointer<NiAVObject> GetTorsoNode(Actor *actor);
@@ -97,6 +135,10 @@ std::tuple<EquipData, int> GetEquipDataForBipedObject(Actor *actor, Biped *biped
 
 double GetTime();
 
+// Bumped whenever the player's 3D or either of their 1st/3rd person roots change. Anything caching nodes from the player's skeleton should re-resolve them when this changes.
+extern UInt32 g_playerNodesGeneration;
+UInt32 UpdatePlayerNodesGeneration();
+
 bool VisitNodes(NiAVObject  *parent, std::function<bool(NiAVObject*, int)> functor, int depth = 0);
 
 inline void ltrim(std::string &s) { s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](unsigned char ch) { return !::isspace(ch); })); }
@@ -143,6 +185,33 @@ void CollectRelevantNonMoveableRigidBodies(std::set<NiPointer<bhkRigidBody>> &in
 void CollectAllConnectedRigidBodies(NiAVObject *root, bhkRigidBody *connectee, std::set<RE::hkRefPtr<hkpRigidBody>> &out);
 bool CollectAllGrabbedRigidBodies(NiAVObject *root, bhkRigidBody *grabbedBody, std::set<NiPointer<bhkRigidBody>> &out);
 void ForEachAdjacentBody(NiAVObject *root, bhkRigidBody *body, std::function<void(hkpRigidBody *)> f, int waves = 1);
+
+// The bodies affected by holding a constrained object (like a ragdoll). Collected once when it's grabbed, instead of walking the constraint graph every frame.
+struct ConstrainedBodySnapshot
+{
+    struct ConstraintState
+    {
+        NiPointer<bhkConstraint> constraint;
+        bool isEnabled;
+        bool isAddedToWorld;
+    };
+
+    NiPointer<NiAVObject> root = nullptr;
+    NiPointer<bhkRigidBody> grabbedBody = nullptr;
+    int numGrabbedBodyConstraints = 0;
+    int adjacencyWaves = 0;
+    bool isRagdolled = false;
+
+    std::vector<NiPointer<bhkRigidBody>> connectedBodies{}; // CollectAllGrabbedRigidBodies()
+    bool isAttachedToFixed = false;
+    std::vector<NiPointer<bhkRigidBody>> adjacentBodies{}; // ForEachAdjacentBody() with adjacencyWaves, if that's > 0
+
+    std::vector<ConstraintState> constraints{}; // every constraint under root, as it was when collected
+    size_t nextConstraintToVerify = 0;
+};
+void BuildConstrainedBodySnapshot(NiAVObject *root, bhkRigidBody *grabbedBody, int adjacencyWaves, bool isRagdolled, ConstrainedBodySnapshot &snapshotOut);
+// Cheap check that nothing the snapshot was built from has changed. Only a few of its constraints are re-checked per call, so changes to those are picked up over a few frames.
+bool IsConstrainedBodySnapshotValid(ConstrainedBodySnapshot &snapshot, NiAVObject *root, bhkRigidBody *grabbedBody, int adjacencyWaves, bool isRagdolled);
 inline TESRace * Actor_GetRace(Actor *actor) { return *((TESRace **)((UInt64)actor + 0x1F0)); }
 
 inline void SetProjectileFlags(Projectile *projectile, UInt32 flags) { *((UInt32 *)((UInt64)projectile + 0x1cc)) = flags; }
@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstdarg>
+#include <cstdlib>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+#include "async_log.h"
+
+
+namespace AsyncLog {
+    constexpr size_t g_queueSize = 1024; // must be a power of 2
+    constexpr size_t g_maxMessageLength = 1024;
+
+    struct Record
+    {
+        std::atomic<size_t> sequence; // which round of the queue this slot is ready to be written / read in
+        size_t position;
+        const char *fmt;
+        FormatFunc format;
+        alignas(16) char args[g_maxArgsSize];
+    };
+
+    // Bounded multi-producer queue (Vyukov). Producers only ever touch the slot they claimed, so they never wait on each other or on the writer thread.
+    Record g_records[g_queueSize];
+    alignas(64) std::atomic<size_t> g_enqueuePosition = 0;
+    alignas(64) size_t g_dequeuePosition = 0;
+
+    std::atomic<UInt64> g_numDropped = 0;
+    std::mutex g_consumeLock; // only between the writer thread and Flush()
+    std::recursive_mutex g_logLock; // held for every write to gLog, from any thread
+    std::atomic<bool> g_isStarted = false;
+
+    const char *g_categoryNames[] = { "General", "Selection", "Grab", "Geometry", "Fingers", "Physics" };
+    static_assert(std::size(g_categoryNames) == size_t(Category::Count));
+
+    struct QueueInit
+    {
+        QueueInit()
+        {
+            for (size_t i = 0; i < g_queueSize; i++) {
+                g_records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    } g_queueInit;
+
+
+    int GetLevel(Category category)
+    {
+        int level = -1;
+        switch (category) {
+        case Category::Selection: level = Config::options.logLevelSelection; break;
+        case Category::Grab: level = Config::options.logLevelGrab; break;
+        case Category::Geometry: level = Config::options.logLevelGeometry; break;
+        case Category::Fingers: level = Config::options.logLevelFingers; break;
+        case Category::Physics: level = Config::options.logLevelPhysics; break;
+        default: break;
+        }
+        return level >= 0 ? level : Config::options.logLevel;
+    }
+
+    Record * BeginRecord()
+    {
+        size_t position = g_enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Record &record = g_records[position & (g_queueSize - 1)];
+            size_t sequence = record.sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(position);
+            if (diff == 0) {
+                if (g_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    record.position = position;
+                    return &record;
+                }
+                // position was updated by the failed exchange
+            }
+            else if (diff < 0) {
+                // The writer hasn't caught up with this slot yet
+                g_numDropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else {
+                position = g_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void * GetArgsStorage(Record *record)
+    {
+        return record->args;
+    }
+
+    void CommitRecord(Record *record, const char *fmt, FormatFunc format)
+    {
+        record->fmt = fmt;
+        record->format = format;
+        record->sequence.store(record->position + 1, std::memory_order_release);
+    }
+
+    // Must be called with g_consumeLock held. Returns the number of messages written.
+    int Drain()
+    {
+        char message[g_maxMessageLength];
+        int numWritten = 0;
+
+        while (true) {
+            Record &record = g_records[g_dequeuePosition & (g_queueSize - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != g_dequeuePosition + 1) break; // nothing (fully) written here yet
+
+            int length = record.format(message, sizeof(message), record.fmt, record.args);
+            if (length < 0) {
+                strncpy_s(message, record.fmt, _TRUNCATE);
+            }
+
+            record.sequence.store(g_dequeuePosition + g_queueSize, std::memory_order_release);
+            ++g_dequeuePosition;
+
+            {
+                std::scoped_lock lock(g_logLock);
+                gLog.Message(message);
+            }
+            ++numWritten;
+        }
+
+        if (UInt64 numDropped = g_numDropped.exchange(0, std::memory_order_relaxed)) {
+            snprintf(message, sizeof(message), "Async log queue was full, dropped %llu messages", numDropped);
+            std::scoped_lock lock(g_logLock);
+            gLog.Message(message);
+        }
+
+        return numWritten;
+    }
+
+    void Flush()
+    {
+        std::scoped_lock lock(g_consumeLock);
+        Drain();
+    }
+
+    static void FlushAtExit()
+    {
+        // Other threads have already been killed by now, possibly while holding a lock, so don't wait on either of them
+        std::unique_lock consumeLock(g_consumeLock, std::try_to_lock);
+        std::unique_lock logLock(g_logLock, std::try_to_lock);
+        if (consumeLock.owns_lock() && logLock.owns_lock()) {
+            Drain();
+        }
+    }
+
+    static void LogLocked(IDebugLog::LogLevel level, const char *fmt, va_list args)
+    {
+        std::scoped_lock lock(g_logLock);
+        gLog.Log(level, fmt, args);
+    }
+
+#define HIGGS_DEFINE_LOCKED_LOG_FUNCTION(name, level) \
+    void name(const char *fmt, ...) \
+    { \
+        va_list args; \
+        va_start(args, fmt); \
+        LogLocked(level, fmt, args); \
+        va_end(args); \
+    }
+
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(FatalError, IDebugLog::kLevel_FatalError)
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(Error, IDebugLog::kLevel_Error)
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(Warning, IDebugLog::kLevel_Warning)
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(Message, IDebugLog::kLevel_Message)
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(VerboseMessage, IDebugLog::kLevel_VerboseMessage)
+    HIGGS_DEFINE_LOCKED_LOG_FUNCTION(DebugMessage, IDebugLog::kLevel_DebugMessage)
+
+#undef HIGGS_DEFINE_LOCKED_LOG_FUNCTION
+
+    void Loop()
+    {
+        while (true) {
+            int numWritten;
+            {
+                std::scoped_lock lock(g_consumeLock);
+                numWritten = Drain();
+            }
+
+            if (numWritten == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    }
+
+    void Start()
+    {
+        if (g_isStarted.exchange(true)) return;
+
+        for (int i = 0; i < int(Category::Count); i++) {
+            int level = GetLevel(Category(i));
+            if (level != Config::options.logLevel) {
+                AsyncLog::Message("Log level for %s: %d", g_categoryNames[i], level);
+            }
+        }
+
+        std::thread(Loop).detach();
+        std::atexit(FlushAtExit); // there is no SKSE message for the game exiting
+    }
+}
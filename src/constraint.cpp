@@ -203,3 +203,61 @@ float GetMaxForceForFPS(float fps, std::map<float, float> &fpsToMaxForceMap)
         return lerp(maxForce1, maxForce2, t);
     }
 }
+
+static GrabMotorProfile::Schedule MakeSchedule(float start, float end, double duration)
+{
+    if (duration <= 0.0) {
+        return { end, end, 0.0 }; // already at the end
+    }
+    return { start, end, 1.0 / duration };
+}
+
+void BuildGrabMotorProfile(bool isActor, bool isWeapon, GrabMotorProfile &profileOut)
+{
+    profileOut.optionsVersion = Config::g_optionsVersion;
+    profileOut.isActor = isActor;
+    profileOut.isWeapon = isWeapon;
+
+    std::map<float, float> &linearMap = Config::options.fpsToActorMaxForceMultiplierMapLinear;
+    std::map<float, float> &angularMap = Config::options.fpsToActorMaxForceMultiplierMapAngular;
+    float minFPS = (std::min)(linearMap.begin()->first, angularMap.begin()->first);
+    float maxFPS = (std::max)(linearMap.rbegin()->first, angularMap.rbegin()->first);
+    float fpsStep = (maxFPS - minFPS) / (GrabMotorProfile::numTableEntries - 1);
+
+    profileOut.tableMinFPS = minFPS;
+    profileOut.invTableFPSStep = fpsStep > 0.f ? 1.f / fpsStep : 0.f; // with a single key, every fps samples the first entry
+
+    for (int i = 0; i < GrabMotorProfile::numTableEntries; i++) {
+        float fps = minFPS + fpsStep * i;
+        profileOut.linearMaxForceActorByFPS[i] = GetMaxForceForFPS(fps, Config::options.fpsToActorMaxForceMultiplierMapLinear) * Config::options.grabConstraintLinearMaxForceActor;
+        profileOut.angularMaxForceActorByFPS[i] = GetMaxForceForFPS(fps, Config::options.fpsToActorMaxForceMultiplierMapAngular) * Config::options.grabConstraintAngularMaxForceActor;
+    }
+    profileOut.linearTauActor = Config::options.grabConstraintLinearTauActor;
+    profileOut.angularTauActor = Config::options.grabConstraintAngularTauActor;
+
+    profileOut.linearTauBody = MakeSchedule(Config::options.grabConstraintLinearTauBodyStart, Config::options.grabConstraintLinearTauBody, Config::options.physicsGrabLerpTauTimeBody);
+    profileOut.angularTauBody = MakeSchedule(Config::options.grabConstraintAngularTauBodyStart, Config::options.grabConstraintAngularTauBody, Config::options.physicsGrabLerpTauTimeBody);
+
+    profileOut.linearMaxForce = isWeapon ? Config::options.grabConstraintLinearMaxForceWeapon : Config::options.grabConstraintLinearMaxForce;
+    profileOut.maxForceToMassRatio = Config::options.grabConstraintMaxForceToMassRatio;
+
+    profileOut.angularToLinearForceRatioFadeIn = MakeSchedule(Config::options.grabConstraintFadeInStartAngularMaxForceRatio, Config::options.grabConstraintAngularToLinearForceRatio, Config::options.grabConstraintFadeInTime);
+    profileOut.angularToLinearForceRatio = Config::options.grabConstraintAngularToLinearForceRatio;
+
+    profileOut.linearTau = Config::options.grabConstraintLinearTau;
+    profileOut.angularTau = Config::options.grabConstraintAngularTau;
+    profileOut.collidingLinearTau = Config::options.grabConstraintCollidingLinearTau;
+    profileOut.collidingAngularTau = Config::options.grabConstraintCollidingAngularTau;
+    profileOut.tauLerpSpeed = Config::options.grabConstraintTauLerpSpeed;
+
+    profileOut.linearMotor = {
+        Config::options.grabConstraintLinearProportionalRecoveryVelocity,
+        Config::options.grabConstraintLinearConstantRecoveryVelocity,
+        Config::options.grabConstraintLinearDamping
+    };
+    profileOut.angularMotor = {
+        Config::options.grabConstraintAngularProportionalRecoveryVelocity,
+        Config::options.grabConstraintAngularConstantRecoveryVelocity,
+        Config::options.grabConstraintAngularDamping
+    };
+}
@@ -10,6 +10,7 @@
 #include <winrt/base.h>
 
 #include "skse64/GameReferences.h"
+#include "async_log.h"
 
 
 namespace Draw {
@@ -58,7 +59,7 @@ namespace Draw {
 
         HRESULT result = g_renderGlobals->device->CreateBuffer(&vertexBufferDesc, &vertexData, buffers.vertexBuffer.GetAddressOf());
         if (FAILED(result)) {
-            _ERROR("Failed to create vertex buffer");
+            AsyncLog::Error("Failed to create vertex buffer");
             return buffers;
         }
 
@@ -77,7 +78,7 @@ namespace Draw {
 
         result = g_renderGlobals->device->CreateBuffer(&indexBufferDesc, &indexData, buffers.indexBuffer.GetAddressOf());
         if (FAILED(result)) {
-            _ERROR("Failed to create index buffer");
+            AsyncLog::Error("Failed to create index buffer");
             return buffers;
         }
 
@@ -110,7 +111,7 @@ namespace Draw {
 
         HRESULT result = g_renderGlobals->device->CreateBuffer(&cameraBufferDesc, nullptr, &g_cameraBuffer);
         if (FAILED(result)) {
-            _ERROR("Failed to create camera buffer");
+            AsyncLog::Error("Failed to create camera buffer");
         }
 
         // Create model buffer
@@ -124,7 +125,7 @@ namespace Draw {
 
         result = g_renderGlobals->device->CreateBuffer(&modelBufferDesc, nullptr, &g_modelBuffer);
         if (FAILED(result)) {
-            _ERROR("Failed to create model buffer");
+            AsyncLog::Error("Failed to create model buffer");
         }
     }
 
@@ -151,7 +152,7 @@ namespace Draw {
         desc.AntialiasedLineEnable = false;
         HRESULT result = g_renderGlobals->device->CreateRasterizerState(&desc, &g_rasterizerState);
         if (FAILED(result)) {
-            _ERROR("Failed to create rasterizer state");
+            AsyncLog::Error("Failed to create rasterizer state");
         }
     }
 
@@ -242,15 +243,15 @@ PS_OUTPUT main(PS_INPUT input) {
         );
 
         if (FAILED(result)) {
-            _ERROR("Vertex shader failed to compile");
+            AsyncLog::Error("Vertex shader failed to compile");
             if (errorBlob) {
-                _ERROR(static_cast<LPCSTR>(errorBlob->GetBufferPointer()));
+                AsyncLog::Error(static_cast<LPCSTR>(errorBlob->GetBufferPointer()));
             }
         }
 
         result = g_renderGlobals->device->CreateVertexShader(vertexShaderBinary->GetBufferPointer(), vertexShaderBinary->GetBufferSize(), nullptr, &g_vertexShader);
         if (FAILED(result)) {
-            _ERROR("Failed to create vertex shader");
+            AsyncLog::Error("Failed to create vertex shader");
         }
 
         // Create pixel shader
@@ -273,13 +274,13 @@ PS_OUTPUT main(PS_INPUT input) {
 
         if (FAILED(result)) {
             if (errorBlob) {
-                _ERROR(static_cast<LPCSTR>(errorBlob->GetBufferPointer()));
+                AsyncLog::Error(static_cast<LPCSTR>(errorBlob->GetBufferPointer()));
             }
         }
 
         result = g_renderGlobals->device->CreatePixelShader(pixelShaderBinary->GetBufferPointer(), pixelShaderBinary->GetBufferSize(), nullptr, &g_pixelShader);
         if (FAILED(result)) {
-            _ERROR("Failed to create pixel shader");
+            AsyncLog::Error("Failed to create pixel shader");
         }
 
         // Create input layout
@@ -293,7 +294,7 @@ PS_OUTPUT main(PS_INPUT input) {
             &g_inputLayout
         );
         if (FAILED(result)) {
-            _ERROR("Failed to create input layout");
+            AsyncLog::Error("Failed to create input layout");
         }
     }
 
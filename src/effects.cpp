@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
 #include "RE/offsets.h"
 #include "effects.h"
 #include "utils.h"
@@ -32,36 +37,62 @@ void ClearEffectDataMap()
     }
 }
 
-void SaveShaderData(UInt32 handle, NiAVObject *root)
+// Shader effects that could be playing on an object's geometry, from a single pass over the active magic effects
+struct ShaderEffectIndex
+{
+    struct Candidate
+    {
+        NiPointer<ShaderReferenceEffect> shaderReference;
+        int effectIndex; // position in magicEffects, since the last matching effect is the one that gets saved
+    };
+
+    // Keyed by the effect's shader data and attach root. Effects without an attach root are only included if they target the object.
+    std::map<std::pair<BSEffectShaderData *, NiAVObject *>, Candidate> effects;
+};
+
+void BuildShaderEffectIndex(UInt32 handle, ShaderEffectIndex &index)
+{
+    ProcessLists *processLists = *g_processLists;
+    SimpleLocker locker(&processLists->magicEffectsLock);
+
+    for (int i = 0; i < processLists->magicEffects.count; i++) {
+        NiPointer<BSTempEffect> effect = processLists->magicEffects.entries[i];
+        ShaderReferenceEffect *shaderReference = DYNAMIC_CAST(effect, BSTempEffect, ShaderReferenceEffect);
+        if (!shaderReference || !shaderReference->effectShaderData) continue;
+
+        TESEffectShader *shader = shaderReference->effectData;
+        if (shader == g_rightHand->itemSelectedShader || shader == g_rightHand->itemSelectedShaderOffLimits) continue; // Only save shader data for shaders that are not our own
+
+        // We only care about saving shader data if it's a shader effect
+        NiAVObject *attachRoot = (shaderReference->ownController && shaderReference->controller) ? shaderReference->controller->attachRoot : nullptr;
+        if (!attachRoot && shaderReference->target != handle) continue;
+
+        index.effects[{ shaderReference->effectShaderData, attachRoot }] = { shaderReference, i };
+    }
+}
+
+void SaveShaderData(UInt32 handle, NiAVObject *root, const ShaderEffectIndex &index)
 {
     BSGeometry *geom = root->GetAsBSGeometry();
     if (geom) {
         auto shaderProperty = DYNAMIC_CAST(geom->m_spEffectState, NiProperty, BSLightingShaderProperty);
         if (shaderProperty) {
-            NiPointer<BSEffectShaderData> effectData = (BSEffectShaderData *)shaderProperty->unk68;
+            BSEffectShaderData *effectData = (BSEffectShaderData *)shaderProperty->unk68;
             if (effectData) {
-                ProcessLists *processLists = *g_processLists;
-                {
-                    SimpleLocker locker(&processLists->magicEffectsLock);
-
-                    for (int i = 0; i < processLists->magicEffects.count; i++) {
-                        NiPointer<BSTempEffect> effect = processLists->magicEffects.entries[i];
-                        ShaderReferenceEffect *shaderReference = DYNAMIC_CAST(effect, BSTempEffect, ShaderReferenceEffect);
-                        if (shaderReference) {
-                            // We only care about saving shader data if it's a shader effect
-                            NiPointer<NiAVObject> attachRoot = (shaderReference->ownController && shaderReference->controller) ? shaderReference->controller->attachRoot : nullptr;
-                            if ((shaderReference->target == handle && !attachRoot) || attachRoot == root) {
-                                if (shaderReference->effectShaderData == effectData) { // Make sure we save the shader that's actually affecting the node
-                                    TESEffectShader *shader = shaderReference->effectData;
-                                    if (shader != g_rightHand->itemSelectedShader && shader != g_rightHand->itemSelectedShaderOffLimits) {
-                                        // Only save shader data for shaders that are not our own
-                                        g_effectDataMap[root] = shaderReference;
-                                    }
-                                }
-                            }
-                        }
+                // Make sure we save the shader that's actually affecting the node, either attached to this node or playing on the object as a whole
+                const ShaderEffectIndex::Candidate *match = nullptr;
+                if (auto it = index.effects.find({ effectData, root }); it != index.effects.end()) {
+                    match = &it->second;
+                }
+                if (auto it = index.effects.find({ effectData, nullptr }); it != index.effects.end()) {
+                    if (!match || it->second.effectIndex > match->effectIndex) {
+                        match = &it->second;
                     }
                 }
+
+                if (match) {
+                    g_effectDataMap[root] = match->shaderReference;
+                }
             }
         }
     }
@@ -71,39 +102,32 @@ void SaveShaderData(UInt32 handle, NiAVObject *root)
         for (int i = 0; i < node->m_children.m_emptyRunStart; i++) {
             NiAVObject *child = node->m_children.m_data[i];
             if (child) {
-                SaveShaderData(handle, child);
+                SaveShaderData(handle, child, index);
             }
         }
     }
 }
 
-void RestoreShaderData(UInt32 handle, NiAVObject *root)
+void SaveShaderData(UInt32 handle, NiAVObject *root)
+{
+    ShaderEffectIndex index;
+    BuildShaderEffectIndex(handle, index);
+    if (index.effects.empty()) return;
+
+    SaveShaderData(handle, root, index);
+}
+
+void RestoreShaderData(UInt32 handle, NiAVObject *root, const std::unordered_map<ShaderReferenceEffect *, NiPointer<BSEffectShaderData>> &playingShaderData)
 {
     BSGeometry *geom = root->GetAsBSGeometry();
     if (geom) {
         auto shaderProperty = DYNAMIC_CAST(geom->m_spEffectState, NiProperty, BSShaderProperty);
         if (shaderProperty) {
-            if (g_effectDataMap.count(root) != 0) {
-                NiPointer<ShaderReferenceEffect> savedShaderReference = g_effectDataMap[root];
-
+            if (auto saved = g_effectDataMap.find(root); saved != g_effectDataMap.end()) {
                 // Make sure the shader that was playing when we saved the shader data is still playing now that we're restoring its data
-                ProcessLists *processLists = *g_processLists;
-                {
-                    SimpleLocker locker(&processLists->magicEffectsLock);
-
-                    for (int i = 0; i < processLists->magicEffects.count; i++) {
-                        NiPointer<BSTempEffect> effect = processLists->magicEffects.entries[i];
-                        ShaderReferenceEffect *shaderReference = DYNAMIC_CAST(effect, BSTempEffect, ShaderReferenceEffect);
-                        if (shaderReference) {
-                            if (shaderReference->target == handle && shaderReference == savedShaderReference) {
-                                NiPointer<BSEffectShaderData> shaderData = shaderReference->effectShaderData;
-                                if (shaderData) {
-                                    *((NiPointer<BSEffectShaderData> *)&shaderProperty->unk68) = shaderData;
-                                    g_effectDataMap.erase(root);
-                                }
-                            }
-                        }
-                    }
+                if (auto it = playingShaderData.find(saved->second); it != playingShaderData.end()) {
+                    *((NiPointer<BSEffectShaderData> *)&shaderProperty->unk68) = it->second;
+                    g_effectDataMap.erase(saved);
                 }
             }
         }
@@ -114,14 +138,94 @@ void RestoreShaderData(UInt32 handle, NiAVObject *root)
         for (int i = 0; i < node->m_children.m_emptyRunStart; i++) {
             NiAVObject *child = node->m_children.m_data[i];
             if (child) {
-                RestoreShaderData(handle, child);
+                RestoreShaderData(handle, child, playingShaderData);
             }
         }
     }
 }
 
+void RestoreShaderData(UInt32 handle, NiAVObject *root)
+{
+    if (g_effectDataMap.empty()) return;
+
+    // Shader data of the shader effects still playing on the object
+    std::unordered_map<ShaderReferenceEffect *, NiPointer<BSEffectShaderData>> playingShaderData;
+    {
+        ProcessLists *processLists = *g_processLists;
+        SimpleLocker locker(&processLists->magicEffectsLock);
+
+        for (int i = 0; i < processLists->magicEffects.count; i++) {
+            NiPointer<BSTempEffect> effect = processLists->magicEffects.entries[i];
+            ShaderReferenceEffect *shaderReference = DYNAMIC_CAST(effect, BSTempEffect, ShaderReferenceEffect);
+            if (shaderReference && shaderReference->target == handle && shaderReference->effectShaderData) {
+                playingShaderData[shaderReference] = shaderReference->effectShaderData;
+            }
+        }
+    }
+    if (playingShaderData.empty()) return;
+
+    RestoreShaderData(handle, root, playingShaderData);
+}
 
-std::shared_mutex g_shaderNodesLock;
+
+std::atomic<const ShaderNodeSnapshot *> g_shaderNodes = nullptr;
+std::atomic<int> g_numShaderNodeReaders = 0;
+std::mutex g_shaderNodesWriteLock; // only between writers
+std::vector<const ShaderNodeSnapshot *> g_retiredShaderNodes{}; // replaced snapshots that a reader may still be looking at. Guarded by g_shaderNodesWriteLock.
+
+bool ShaderNodeSnapshot::Contains(ShaderReferenceEffect *shaderReference, BSGeometry *geometry) const
+{
+    // There are only ever a couple of shaders playing at once
+    for (const Entry &entry : entries) {
+        if (entry.shaderReference == shaderReference) {
+            return std::binary_search(entry.geometry.begin(), entry.geometry.end(), geometry);
+        }
+    }
+    return false;
+}
+
+bool IsShaderNodeGeometry(ShaderReferenceEffect *shaderReference, BSGeometry *geometry)
+{
+    g_numShaderNodeReaders.fetch_add(1);
+    const ShaderNodeSnapshot *snapshot = g_shaderNodes.load();
+    bool contains = snapshot && snapshot->Contains(shaderReference, geometry);
+    g_numShaderNodeReaders.fetch_sub(1);
+    return contains;
+}
+
+// Must be called with g_shaderNodesWriteLock held
+void PublishShaderNodes(const ShaderNodeSnapshot *snapshot)
+{
+    if (const ShaderNodeSnapshot *oldSnapshot = g_shaderNodes.exchange(snapshot)) {
+        g_retiredShaderNodes.push_back(oldSnapshot);
+    }
+
+    // Any reader that starts after the exchange will see the new snapshot, so once there are no readers at all, nobody can be looking at the old ones
+    if (g_numShaderNodeReaders.load() == 0) {
+        for (const ShaderNodeSnapshot *retired : g_retiredShaderNodes) {
+            delete retired;
+        }
+        g_retiredShaderNodes.clear();
+    }
+}
+
+// Must be called with g_shaderNodesWriteLock held. The entry for shaderReference is replaced, or removed if geometry is null.
+void UpdateShaderNodes(ShaderReferenceEffect *shaderReference, std::vector<BSGeometry *> *geometry)
+{
+    ShaderNodeSnapshot *snapshot = new ShaderNodeSnapshot;
+    if (const ShaderNodeSnapshot *current = g_shaderNodes.load()) {
+        for (const ShaderNodeSnapshot::Entry &entry : current->entries) {
+            if (entry.shaderReference != shaderReference) {
+                snapshot->entries.push_back(entry);
+            }
+        }
+    }
+    if (geometry) {
+        snapshot->entries.push_back({ shaderReference, std::move(*geometry) });
+    }
+
+    PublishShaderNodes(snapshot);
+}
 
 
 const size_t g_vtblSize = 0x40; // 0x3F vfuncs + typeinfo above vtable
@@ -135,14 +239,14 @@ void HookedShaderReferenceEffectDtor(ShaderReferenceEffect *_this)
 {
     {
         // Clear the nodes from the map for this reference effect
-        std::unique_lock lock(g_shaderNodesLock);
-        g_shaderNodes.erase(_this);
+        std::scoped_lock lock(g_shaderNodesWriteLock);
+        UpdateShaderNodes(_this, nullptr);
     }
 
     ((_ShaderReferenceEffectDtor)g_shaderReferenceEffectDtor)(_this);
 }
 
-void FillGeometryNodes(NiAVObject *root, std::unordered_set<BSGeometry *> &geometryNodes, bool terminateAtCollision)
+void FillGeometryNodes(NiAVObject *root, std::vector<BSGeometry *> &geometryNodes, bool terminateAtCollision)
 {
     // Populate geometry nodes until we hit nodes with their own collision
 
@@ -156,7 +260,7 @@ void FillGeometryNodes(NiAVObject *root, std::unordered_set<BSGeometry *> &geome
                 // It's skin geometry, so don't play the shader on it
             }
             else {
-                geometryNodes.insert(geom);
+                geometryNodes.push_back(geom);
             }
         }
     }
@@ -208,11 +312,14 @@ void CommitShaderNodes(ShaderReferenceEffect *shaderReference, NiAVObject *node,
 {
     // The nodes that get put into the set are the ones that actually get the shader to play on them
 
-    std::unordered_set<BSGeometry *> geometryNodes;
+    std::vector<BSGeometry *> geometryNodes;
     FillGeometryNodes(node, geometryNodes, terminateAtCollision);
 
-    std::unique_lock lock(g_shaderNodesLock);
-    g_shaderNodes[shaderReference] = std::move(geometryNodes);
+    std::sort(geometryNodes.begin(), geometryNodes.end());
+    geometryNodes.erase(std::unique(geometryNodes.begin(), geometryNodes.end()), geometryNodes.end());
+
+    std::scoped_lock lock(g_shaderNodesWriteLock);
+    UpdateShaderNodes(shaderReference, &geometryNodes);
 }
 
 void PlayShader(UInt32 objHandle, NiAVObject *node, TESEffectShader *shader, bool saveCurrentShader)
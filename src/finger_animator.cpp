@@ -13,25 +13,16 @@
 
 NiPoint3 FingerAnimator::LerpFingerPosition(int finger, int knuckle, float lerpVal)
 {
+    const FingerPoseTable &poses = g_fingerPoseTables[isLeft];
     int curve = animCurves[finger];
-    NiPoint3 pos = lerp(g_closedFingerPositions[curve][knuckle], g_openFingerPositions[curve][knuckle], lerpVal);
-    if (isLeft) {
-        pos.x *= -1;
-    }
-    return pos;
+    return lerp(poses.closedPositions[curve][knuckle], poses.openPositions[curve][knuckle], lerpVal);
 }
 
-NiMatrix33 FingerAnimator::LerpFingerRotation(int finger, int knuckle, float lerpVal)
+NiQuaternion FingerAnimator::LerpFingerRotation(int finger, int knuckle, float lerpVal)
 {
+    const FingerPoseTable &poses = g_fingerPoseTables[isLeft];
     int curve = animCurves[finger];
-    NiMatrix33 rot = QuaternionToMatrix(slerp(g_closedFingerRotations[curve][knuckle], g_openFingerRotations[curve][knuckle], lerpVal));
-    if (isLeft) {
-        NiPoint3 euler = MatrixToEuler(rot);
-        euler.y *= -1;
-        euler.z *= -1;
-        rot = EulerToMatrix(euler);
-    }
-    return rot;
+    return slerp(poses.closedRotations[curve][knuckle], poses.openRotations[curve][knuckle], lerpVal);
 }
 
 bool FillFingerNodes(NiPointer<NiAVObject> fingerNodes[5][3], BSFixedString fingerNodeNames[5][3])
@@ -52,12 +43,30 @@ bool FillFingerNodes(NiPointer<NiAVObject> fingerNodes[5][3], BSFixedString fing
     return false;
 }
 
+bool FingerAnimator::UpdateFingerNodes()
+{
+    // Only search the skeleton for the finger nodes when the player's 3D has changed since we last looked
+    // If the lookup fails, we'll try again next frame
+    UInt32 generation = UpdatePlayerNodesGeneration();
+    if (generation != fingerNodesGeneration || !haveFingerNodes) {
+        fingerNodesGeneration = generation;
+        haveFingerNodes = FillFingerNodes(fingerNodes, fingerNodeNames);
+        if (!haveFingerNodes) {
+            for (int i = 0; i < 5; i++) {
+                for (int j = 0; j < 3; j++) {
+                    fingerNodes[i][j] = nullptr;
+                }
+            }
+        }
+    }
+    return haveFingerNodes;
+}
+
 void FingerAnimator::Update()
 {
     if (!animate) return;
 
-    NiPointer<NiAVObject> fingerNodes[5][3];
-    if (!FillFingerNodes(fingerNodes, fingerNodeNames)) return;
+    if (!UpdateFingerNodes()) return;
 
     float posSpeed = animSpeedLinear;
     float rotSpeed = animSpeedAngular;
@@ -67,44 +76,53 @@ void FingerAnimator::Update()
         rotSpeed += elapsedTimeFraction * animSpeedAngular;
     }
 
-    bool stopAnimating = true;
-    //std::vector<NiAVObject *> stillAnimating;
-    auto AnimateFinger = [this, &fingerNodes, &stopAnimating, posSpeed, rotSpeed](int finger, float lerpVal)
-    {
-        // - When starting to animate, move towards the desired state at a fixed speed
-        // - When ending animating, move towards where the game/vrik wants them at a fixed speed
+    // - When starting to animate, move towards the desired state at a fixed speed
+    // - When ending animating, move towards where the game/vrik wants them at a fixed speed
 
-        // Current local transform: The transform that the game / vrik sets
-        // Old 3rd person finger transform: Ours if we set it last frame, vriks if we didn't
+    // Current local transform: The transform that the game / vrik sets
+    // Old 3rd person finger transform: Ours if we set it last frame, vriks if we didn't
 
+    NiPoint3 desiredPositions[5][3];
+    NiQuaternion desiredRotations[5][3];
+    for (int finger = 0; finger < 5; finger++) {
         for (int i = 0; i < 3; i++) {
-            NiTransform desiredTransform = fingerNodes[finger][i]->m_localTransform;
-            if (animState == AnimState::Start) {
-                desiredTransform.pos = LerpFingerPosition(finger, i, lerpVal);
-                desiredTransform.rot = LerpFingerRotation(finger, i, lerpVal);
-            }
-
-            NiAVObject *fingerNode = fingerNodes[finger][i];
             NiTransform &currentLocalTransform = fingerNodes[finger][i]->m_localTransform;
-            if (saveCurrentTransforms) {
-                localTransforms[finger][i] = currentLocalTransform;
+
+            if (saveCurrentTransforms || animState == AnimState::End) {
+                NiQuaternion currentLocalRotation = MatrixToQuaternion(currentLocalTransform.rot);
+                if (saveCurrentTransforms) {
+                    localPositions[finger][i] = currentLocalTransform.pos;
+                    localRotations[finger][i] = currentLocalRotation;
+                }
+                if (animState == AnimState::End) {
+                    desiredPositions[finger][i] = currentLocalTransform.pos;
+                    desiredRotations[finger][i] = currentLocalRotation;
+                }
             }
 
-            NiTransform &currentTransform = localTransforms[finger][i]; // Is the vrik transform if we just started animating, or our last transform if we already were animating
+            if (animState == AnimState::Start) {
+                desiredPositions[finger][i] = LerpFingerPosition(finger, i, animValues[finger]);
+                desiredRotations[finger][i] = LerpFingerRotation(finger, i, animValues[finger]);
+            }
+        }
+    }
 
-            std::optional<NiTransform> advancedTransform = AdvanceTransform(currentTransform, desiredTransform, posSpeed, rotSpeed);
-            NiTransform finalTransform;
-            if (advancedTransform) {
+    bool stopAnimating = true;
+    for (int finger = 0; finger < 5; finger++) {
+        for (int i = 0; i < 3; i++) {
+            // localPositions/localRotations are the vrik transform if we just started animating, or our last transform if we already were animating
+            if (AdvancePose(localPositions[finger][i], localRotations[finger][i], desiredPositions[finger][i], desiredRotations[finger][i], posSpeed, rotSpeed)) {
                 // This part of the finger has not reached its destination yet - keep animating
-                finalTransform = *advancedTransform;
                 stopAnimating = false;
-                //stillAnimating.push_back(fingerNode);
             }
-            else {
-                finalTransform = desiredTransform;
-            }
-            localTransforms[finger][i] = finalTransform;
-            fingerNodes[finger][i]->m_localTransform = finalTransform;
+        }
+    }
+
+    for (int finger = 0; finger < 5; finger++) {
+        for (int i = 0; i < 3; i++) {
+            NiTransform &currentLocalTransform = fingerNodes[finger][i]->m_localTransform;
+            currentLocalTransform.pos = localPositions[finger][i];
+            currentLocalTransform.rot = QuaternionToMatrix(localRotations[finger][i]);
         }
 
         if (!g_isVrikPresent) {
@@ -112,17 +130,7 @@ void FingerAnimator::Update()
             NiAVObject::ControllerUpdateContext ctx{ 0, 0 };
             NiAVObject_UpdateNode(fingerNodes[finger][0], &ctx);
         }
-    };
-
-    for (int i = 0; i < 5; i++) {
-        AnimateFinger(i, animValues[i]);
-    }
-
-    /*std::stringstream str;
-    for (NiAVObject *node : stillAnimating) {
-        str << node->m_name << ", ";
     }
-    _MESSAGE(str.str().c_str());*/
 
     if (animState == AnimState::End && (stopAnimating || g_currentFrameTime - restoreFingersTime > Config::options.fingerAnimateEndTime)) {
         animate = false;
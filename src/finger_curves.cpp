@@ -660,6 +660,36 @@ NiQuaternion g_closedFingerRotations[6][3] =
 };
 
 
+FingerPoseTable g_fingerPoseTables[2]{};
+
+void ComputeFingerPoseTables()
+{
+    for (int curve = 0; curve < 6; curve++) {
+        for (int knuckle = 0; knuckle < 3; knuckle++) {
+            FingerPoseTable &right = g_fingerPoseTables[0];
+            right.openPositions[curve][knuckle] = g_openFingerPositions[curve][knuckle];
+            right.closedPositions[curve][knuckle] = g_closedFingerPositions[curve][knuckle];
+            right.openRotations[curve][knuckle] = g_openFingerRotations[curve][knuckle];
+            right.closedRotations[curve][knuckle] = g_closedFingerRotations[curve][knuckle];
+
+            // Mirroring across the x axis negates the x component of the position.
+            // For the rotation it's the same as negating the y and z euler angles, which for a quaternion means negating its y and z components.
+            FingerPoseTable &left = g_fingerPoseTables[1];
+            left.openPositions[curve][knuckle] = right.openPositions[curve][knuckle];
+            left.openPositions[curve][knuckle].x *= -1;
+            left.closedPositions[curve][knuckle] = right.closedPositions[curve][knuckle];
+            left.closedPositions[curve][knuckle].x *= -1;
+
+            left.openRotations[curve][knuckle] = right.openRotations[curve][knuckle];
+            left.openRotations[curve][knuckle].m_fY *= -1;
+            left.openRotations[curve][knuckle].m_fZ *= -1;
+            left.closedRotations[curve][knuckle] = right.closedRotations[curve][knuckle];
+            left.closedRotations[curve][knuckle].m_fY *= -1;
+            left.closedRotations[curve][knuckle].m_fZ *= -1;
+        }
+    }
+}
+
 NiPoint3 g_fingerZeroAngleVecs[6] =
 {
 { 0.645101, -0.2895, 0.707132 },
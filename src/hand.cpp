@@ -25,6 +25,8 @@
 #include "pluginapi.h"
 #include "main.h"
 #include "constraint.h"
+#include "profiler.h"
+#include "async_log.h"
 
 #include <Physics/Collide/Query/CastUtil/hkpLinearCastInput.h>
 #include <Physics/Collide/Query/CastUtil/hkpWorldRayCastInput.h>
@@ -38,16 +40,8 @@ std::unordered_set<UInt32> softSoundIds { 0x5a284, 0x624ab, 0x3f355 };
 
 // Gets callbacks from havok linear cast
 CdPointCollector cdPointCollector;
-SpecificPointCollector specificPointCollector;
-hkpLinearCastInput linearCastInput;
-RayHitCollector rayHitCollector;
 AllRayHitCollector allRayHitCollector;
 CdBodyPairCollector pairCollector;
-SpecificPairCollector specificPairCollector;
-// 'ItemPicker' collision layer; player collision group
-// Why ItemPicker? It ignores stuff like weapons the player is holding
-//static hkpWorldRayCastInput rayCastInput(0x02420028);
-hkpWorldRayCastInput rayCastInput;
 
 
 void Hand::TriggerCollisionHaptics(float mass, float speed)
@@ -69,6 +63,7 @@ void Hand::TriggerCollisionHaptics(float mass, float speed)
 void Hand::Select(TESObjectREFR *obj)
 {
     selectedObject.handle = GetOrCreateRefrHandle(obj);
+    InvalidateResolvedSelection();
 
     selectedObject.isImpactedProjectile = false;
     TESForm *baseForm = obj->baseForm;
@@ -101,6 +96,7 @@ void Hand::Deselect()
 
     selectedObject.handle = *g_invalidRefHandle;
     selectedObject.collidable = nullptr;
+    InvalidateResolvedSelection();
     selectedObject.rigidBody = nullptr;
     selectedObject.shaderNode = nullptr;
     selectedObject.hitNode = nullptr;
@@ -258,7 +254,7 @@ NiPoint3 GetClosestPointToRigidbody(bhkWorld &world, bhkRigidBody *rigidBody, bh
                 }
             } while (closestDistance < 0 && numIterations < maxIterations);
 
-            _MESSAGE("%d external grab closest point iterations", numIterations);
+            HIGGS_MESSAGE(Grab, "%d external grab closest point iterations", numIterations);
 
             sphere->phantom->m_motionState.m_transform.m_translation = translationBefore;
             sphereShape->m_radius = radiusBefore;
@@ -272,7 +268,7 @@ NiPoint3 GetClosestPointToRigidbody(bhkWorld &world, bhkRigidBody *rigidBody, bh
 }
 
 
-bool Hand::FindOtherWeapon(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, const bhkSimpleShapePhantom *sphere, hkVector4 &hitPoint)
+bool Hand::FindOtherWeapon(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, hkVector4 &hitPoint)
 {
     NiPointer<bhkRigidBody> otherWeaponBody = other.weaponBody;
     if (!otherWeaponBody) return false;
@@ -282,61 +278,28 @@ bool Hand::FindOtherWeapon(bhkWorld *world, const Hand &other, const NiPoint3 &s
         return false; // Collision is disabled, i.e. weapon is not out
     }
 
-    hkpConvexShape *sphereShape = (hkpConvexShape *)sphere->phantom->m_collidable.m_shape;
-    // Save sphere properties so we can change them and restore them later
-    UInt32 filterInfoBefore = sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo;
-    float radiusBefore = sphereShape->getRadius();
-    hkVector4 translationBefore = sphere->phantom->m_motionState.getTransform().getTranslation();
-
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = 0x2C;
-    sphereShape->m_radius = Config::options.nearCastRadius;
-    sphere->phantom->m_motionState.m_transform.m_translation = NiPointToHkVector(startPos);
-
-    NiPoint3 targetPos = startPos + castDirection * Config::options.nearCastDistance;
-    linearCastInput.m_to = NiPointToHkVector(targetPos);
-    specificPointCollector.reset();
-    specificPointCollector.m_target = otherWeaponCollidable;
-
     // TODO: Would be better (faster) to cast against the weapon shape directly
     world->worldLock.LockForRead();
-    hkpWorld_LinearCast(world->world, &sphere->phantom->m_collidable, &linearCastInput, &specificPointCollector, &specificPointCollector);
-
-    bool found = false;
-    if (specificPointCollector.m_foundTarget) {
-        hitPoint = specificPointCollector.m_contactPoint.getPosition();
-        found = true;
-    }
-
+    bool found = CastSelectionNearAgainst(world, startPos, castDirection, otherWeaponCollidable, hitPoint);
     world->worldLock.UnlockRead();
 
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = filterInfoBefore;
-    sphereShape->m_radius = radiusBefore;
-    sphere->phantom->m_motionState.m_transform.m_translation = translationBefore;
-
     return found;
 }
 
 
-bool Hand::FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, const bhkSimpleShapePhantom *sphere, bool isTwoHandedOffhand,
+bool Hand::FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &startPos, const NiPoint3 &castDirection, bool isTwoHandedOffhand,
     NiPointer<TESObjectREFR> &closestObj, NiPointer<bhkRigidBody> &closestRigidBody, hkVector4 &closestPoint)
 {
     PlayerCharacter *player = *g_thePlayer;
 
-    NiPointer<Actor> lastRiddenHorse; Actor_GetMount(player, lastRiddenHorse);
-
-    hkpConvexShape *sphereShape = (hkpConvexShape *)sphere->phantom->m_collidable.m_shape;
-    // Save sphere properties so we can change them and restore them later
-    UInt32 filterInfoBefore = sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo;
-    float radiusBefore = sphereShape->getRadius();
-    hkVector4 translationBefore = sphere->phantom->m_motionState.getTransform().getTranslation();
-
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = 0x2C;
-    sphereShape->m_radius = Config::options.nearCastRadius;
-    sphere->phantom->m_motionState.m_transform.m_translation = NiPointToHkVector(startPos);
+    if (!selectionQueries.nearCast.IsFor(startPos, castDirection)) {
+        // Not cast ahead of time this frame, or the hand has moved since
+        world->worldLock.LockForRead();
+        CastSelectionNear(world, startPos, castDirection, pulledObject.rigidBody, selectionQueries);
+        world->worldLock.UnlockRead();
+    }
 
-    NiPoint3 targetPos = startPos + castDirection * Config::options.nearCastDistance;
-    linearCastInput.m_to = NiPointToHkVector(targetPos);
-    cdPointCollector.reset();
+    NiPointer<Actor> lastRiddenHorse; Actor_GetMount(player, lastRiddenHorse);
 
     bool otherObjectIsGrabbable = other.CanOtherGrab();
 
@@ -344,67 +307,50 @@ bool Hand::FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &s
     UInt32 pulledHandle = pulledObject.handle;
     LookupREFRByHandle(pulledHandle, pulledObj);
 
-    world->worldLock.LockForRead();
-    hkpWorld_LinearCast(world->world, &sphere->phantom->m_collidable, &linearCastInput, &cdPointCollector, &cdPointCollector);
-
     // Process result of cast
     float closestDistance = (std::numeric_limits<float>::max)();
-    for (auto &pair : cdPointCollector.m_hits) {
-        hkpCollidable *collidable = static_cast<hkpCollidable *>(pair.first);
-        hkpRigidBody *rigidBody = hkpGetRigidBody(collidable);
-        if (!rigidBody || !rigidBody->m_userData) {
-            continue; // No rigidbody -> no movement :/
-        }
-        bhkRigidBody *rigidBodyWrapper = (bhkRigidBody *)rigidBody->m_userData;
-        NiPointer<TESObjectREFR> ref = GetRefFromCollidable(collidable);
+    for (const SelectionCandidate &candidate : selectionQueries.nearCast.candidates) {
+        const NiPointer<TESObjectREFR> &ref = candidate.ref;
         if (ref && ref != player) {
-            if (ref == lastRiddenHorse && collidable->getCollisionFilterInfo() >> 16 == playerCollisionGroup && !Config::options.allowGrabCurrentHorse) continue;
+            if (ref == lastRiddenHorse && candidate.filterInfo >> 16 == playerCollisionGroup && !Config::options.allowGrabCurrentHorse) continue;
 
-            if (IsObjectSelectable(rigidBody, ref) || (collidable == other.selectedObject.collidable && otherObjectIsGrabbable)) {
-                if (ref->baseForm->formType == kFormType_Projectile) {
-                    auto impactData = *(void **)((UInt64)ref.m_pObject + 0x98);
-                    if (!impactData) {
-                        // Only grab projectiles that are not mid flight
-                        continue;
-                    }
+            if (candidate.isSelectable || (candidate.collidable == other.selectedObject.collidable && otherObjectIsGrabbable)) {
+                if (candidate.isProjectileInFlight) {
+                    // Only grab projectiles that are not mid flight
+                    continue;
                 }
                 // Get distance from the hit on the collidable to the ray
-                NiPoint3 hit = HkVectorToNiPoint(pair.second.getPosition());
+                NiPoint3 hit = HkVectorToNiPoint(candidate.point);
                 NiPoint3 startToHit = hit - startPos;
                 float dist = VectorLength(ProjectVectorOntoPlane(startToHit, castDirection)); // distance from hit location to closest point on the ray
                 if (dist < closestDistance) {
                     closestObj = ref;
-                    closestRigidBody = rigidBodyWrapper;
-                    closestPoint = pair.second.getPosition();
+                    closestRigidBody = candidate.rigidBody;
+                    closestPoint = candidate.point;
                     closestDistance = dist;
                 }
             }
         }
-        else if (rigidBodyWrapper == other.weaponBody && isTwoHandedOffhand) {
-            if (collidable->m_broadPhaseHandle.m_collisionFilterInfo & (1 << 14)) {
+        else if (candidate.rigidBody == other.weaponBody && isTwoHandedOffhand) {
+            if (candidate.filterInfo & (1 << 14)) {
                 continue; // Collision is disabled, i.e. weapon is not out
             }
-            NiPoint3 hit = HkVectorToNiPoint(pair.second.getPosition());
+            NiPoint3 hit = HkVectorToNiPoint(candidate.point);
             NiPoint3 startToHit = hit - startPos;
             float dist = VectorLength(ProjectVectorOntoPlane(startToHit, castDirection));
             if (dist < closestDistance) {
                 closestObj = nullptr;
-                closestRigidBody = rigidBodyWrapper;
-                closestPoint = pair.second.getPosition();
+                closestRigidBody = candidate.rigidBody;
+                closestPoint = candidate.point;
                 closestDistance = dist;
             }
         }
     }
 
     bool found = closestDistance != (std::numeric_limits<float>::max)();
-    if (!found && pulledObj) {
-        // No object found normally - do a check for the pulled object in a wider radius
-        sphereShape->m_radius = Config::options.widePullGrabRadius;
-        specificPairCollector.reset();
-        specificPairCollector.m_target = &pulledObject.rigidBody->hkBody->m_collidable;
-        hkpWorld_GetPenetrations(world->world, &sphere->phantom->m_collidable, world->world->m_collisionInput, &specificPairCollector);
-
-        if (specificPairCollector.m_foundTarget) {
+    if (!found && pulledObj && pulledObject.rigidBody) {
+        // No object found normally - check if the pulled object was in the wider radius
+        if (selectionQueries.widePullTarget && selectionQueries.widePullTarget == &pulledObject.rigidBody->hkBody->m_collidable) {
             closestObj = pulledObj;
             closestRigidBody = pulledObject.rigidBody;
             closestPoint = pulledObject.rigidBody->hkBody->m_motion.m_motionState.m_transform.m_translation;
@@ -412,77 +358,32 @@ bool Hand::FindCloseObject(bhkWorld *world, const Hand &other, const NiPoint3 &s
         }
     }
 
-    world->worldLock.UnlockRead();
-
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = filterInfoBefore;
-    sphereShape->m_radius = radiusBefore;
-    sphere->phantom->m_motionState.m_transform.m_translation = translationBefore;
-
     return found;
 }
 
 
-bool Hand::FindFarObject(bhkWorld *world, const Hand &other, const NiPoint3 &start, const NiPoint3 &direction, const NiPoint3 &hkHmdPos, const NiPoint3 &hmdForward, const bhkSimpleShapePhantom *sphere,
+bool Hand::FindFarObject(bhkWorld *world, const Hand &other, const NiPoint3 &start, const NiPoint3 &direction, const NiPoint3 &hkHmdPos, const NiPoint3 &hmdForward,
     NiPointer<TESObjectREFR> &closestObj, NiPointer<bhkRigidBody> &closestRigidBody, hkVector4 &closestPoint)
 {
-    NiPoint3 hkTargetPos = start + direction * Config::options.farCastDistance;
-
-    NiPoint3 hitPosition = { hkTargetPos.x, hkTargetPos.y, hkTargetPos.z };
-
-    // First, raycast in the pointing direction
-    rayHitCollector.reset();
-    rayCastInput.m_filterInfo = ((UInt32)playerCollisionGroup << 16) | 0x28;
-    rayCastInput.m_from = NiPointToHkVector(start);
-    rayCastInput.m_to = NiPointToHkVector(hkTargetPos);
-    world->worldLock.LockForRead();
-    hkpWorld_CastRay(world->world, &rayCastInput, &rayHitCollector);
-    world->worldLock.UnlockRead();
-    if (rayHitCollector.m_doesHitExist) {
-        // If raycast hit, we want to linearcast only up to the ray hit location
-        NiPoint3 startToTarget = hkTargetPos - start;
-        hitPosition = start + (startToTarget * rayHitCollector.m_closestHitInfo.m_hitFraction);// -(VectorNormalized(handToTarget) * Config::options.castRadius);
+    if (!selectionQueries.farCast.IsFor(start, direction)) {
+        // Not cast ahead of time this frame, or the hand has moved since
+        world->worldLock.LockForRead();
+        CastSelectionFar(world, start, direction, playerCollisionGroup, selectionQueries);
+        world->worldLock.UnlockRead();
     }
 
-    hkpConvexShape *sphereShape = (hkpConvexShape *)sphere->phantom->m_collidable.m_shape;
-
-    // Save sphere properties so we can change them and restore them later
-    UInt32 filterInfoBefore = sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo;
-    float radiusBefore = sphereShape->getRadius();
-    hkVector4 translationBefore = sphere->phantom->m_motionState.getTransform().getTranslation();
-
-    // 'CustomPick2' layer, to pick up projectiles, because ONLY THIS GODDAMN LAYER can collide with projectiles. This filterinfo will collide with everything.
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = 0x2C;
-    sphereShape->m_radius = Config::options.farCastRadius;
-    sphere->phantom->m_motionState.m_transform.m_translation = NiPointToHkVector(start);
-
-    // Now, linearcast up to the point the raycast hit, or up to the limit if it's empty space
-    linearCastInput.m_to = NiPointToHkVector(hitPosition);
-    cdPointCollector.reset();
-
-    world->worldLock.LockForRead();
-    hkpWorld_LinearCast(world->world, &sphere->phantom->m_collidable, &linearCastInput, &cdPointCollector, &cdPointCollector);
-
     // Process result of cast
     float closestDistance = (std::numeric_limits<float>::max)();
-    for (auto &pair : cdPointCollector.m_hits) {
-        hkpCollidable *collidable = static_cast<hkpCollidable *>(pair.first);
-        if (other.HasExclusiveObject() && collidable == other.selectedObject.collidable) {
+    for (const SelectionCandidate &candidate : selectionQueries.farCast.candidates) {
+        if (other.HasExclusiveObject() && candidate.collidable == other.selectedObject.collidable) {
             continue;
         }
-        hkpRigidBody *rigidBody = hkpGetRigidBody(collidable);
-        if (!rigidBody || !rigidBody->m_userData) {
-            continue; // No rigidbody -> no movement :/
-        }
-        bhkRigidBody *wrapper = (bhkRigidBody *)rigidBody->m_userData;
-        NiPointer<TESObjectREFR> ref = GetRefFromCollidable(collidable);
+        const NiPointer<TESObjectREFR> &ref = candidate.ref;
         if (ref && ref != *g_thePlayer) {
-            if (IsObjectSelectable(rigidBody, ref)) {
-                if (ref->baseForm->formType == kFormType_Projectile) {
-                    auto impactData = *(void **)((UInt64)ref.m_pObject + 0x98);
-                    if (!impactData) {
-                        // Only grab projectiles that are not mid flight
-                        continue;
-                    }
+            if (candidate.isSelectable) {
+                if (candidate.isProjectileInFlight) {
+                    // Only grab projectiles that are not mid flight
+                    continue;
                 }
                 else if (ref->formType == kFormType_Character) {
                     Actor *actor = DYNAMIC_CAST(ref, TESObjectREFR, Actor);
@@ -496,25 +397,19 @@ bool Hand::FindFarObject(bhkWorld *world, const Hand &other, const NiPoint3 &sta
                     }
                 }
                 // Get distance from the hit on the collidable to the ray
-                NiPoint3 hit = HkVectorToNiPoint(pair.second.getPosition());
+                NiPoint3 hit = HkVectorToNiPoint(candidate.point);
                 NiPoint3 startToHit = hit - start;
                 float dist = VectorLength(ProjectVectorOntoPlane(startToHit, direction)); // distance from hit location to closest point on the ray
                 if (dist < closestDistance && DotProduct(VectorNormalized(hit - hkHmdPos), hmdForward) >= Config::options.requiredCastDotProduct) {
                     closestObj = ref;
-                    closestRigidBody = wrapper;
-                    closestPoint = pair.second.getPosition();
+                    closestRigidBody = candidate.rigidBody;
+                    closestPoint = candidate.point;
                     closestDistance = dist;
                 }
             }
         }
     }
 
-    world->worldLock.UnlockRead();
-
-    sphere->phantom->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo = filterInfoBefore;
-    sphereShape->m_radius = radiusBefore;
-    sphere->phantom->m_motionState.m_transform.m_translation = translationBefore;
-
     return closestDistance != (std::numeric_limits<float>::max)();
 }
 
@@ -717,6 +612,56 @@ void Hand::MoveHandAndWeaponCollision(const NiPoint3 &additionalOffset)
 }
 
 
+// Cloned and rescaled weapon collision shapes, so that re-equipping a weapon or re-creating its collision in a new world doesn't clone the convex data again.
+// Entries keep a reference to the source shape as well, so that its address can't be reused by a different shape while it's a key in here.
+struct WeaponShapeCacheEntry
+{
+    NiPointer<bhkShape> sourceShape;
+    const hkpShape *sourceHkShape;
+    float handSize;
+    float weaponCollisionScale;
+    NiPointer<bhkShape> clonedShape;
+    double lastUsedTime;
+};
+constexpr size_t g_maxCachedWeaponShapes = 8;
+// Heap-allocated and leaked, since the entries hold NiPointers and would crash the game on exit if they were destructed
+std::vector<WeaponShapeCacheEntry> &g_weaponShapeCache = *new std::vector<WeaponShapeCacheEntry>;
+
+bhkShape * GetScaledWeaponShape(bhkShape *shapeWrapper, float handSize)
+{
+    for (WeaponShapeCacheEntry &entry : g_weaponShapeCache) {
+        if (entry.sourceShape == shapeWrapper && entry.sourceHkShape == shapeWrapper->shape && entry.handSize == handSize && entry.weaponCollisionScale == Config::options.weaponCollisionScale) {
+            entry.lastUsedTime = g_currentFrameTime;
+            return entry.clonedShape;
+        }
+    }
+
+    NiCloningProcess cloningProcess = NiCloningProcess();
+    cloningProcess.scale = NiPoint3(1.0f, 1.0f, 1.0f) / *g_fMeleeWeaponHavokScale; // Undo the scaling of the original shape done when creating it
+    cloningProcess.scale *= Config::options.weaponCollisionScale;
+    cloningProcess.scale *= handSize; // Scale by the vrik hand size
+
+    NiPointer<bhkShape> clonedShape = (bhkShape *)NiObject_Clone(shapeWrapper, &cloningProcess);
+    if (!clonedShape) return nullptr;
+
+    if (g_weaponShapeCache.size() >= g_maxCachedWeaponShapes) {
+        // Evict the least recently used shape that no weapon body is using anymore, i.e. that only the cache holds a reference to
+        auto evict = g_weaponShapeCache.end();
+        for (auto it = g_weaponShapeCache.begin(); it != g_weaponShapeCache.end(); ++it) {
+            if (it->clonedShape->m_uiRefCount <= 1 && (evict == g_weaponShapeCache.end() || it->lastUsedTime < evict->lastUsedTime)) {
+                evict = it;
+            }
+        }
+        if (evict != g_weaponShapeCache.end()) {
+            g_weaponShapeCache.erase(evict);
+        }
+    }
+
+    g_weaponShapeCache.push_back({ shapeWrapper, shapeWrapper->shape, handSize, Config::options.weaponCollisionScale, clonedShape, g_currentFrameTime });
+    return clonedShape;
+}
+
+
 void Hand::CreateWeaponCollision(bhkWorld *world)
 {
     if (!Config::options.enableWeaponCollision) return;
@@ -740,16 +685,14 @@ void Hand::CreateWeaponCollision(bhkWorld *world)
     bhkShape *shapeWrapper = (bhkShape *)shape->m_userData;
     if (!shapeWrapper) return;
 
-    NiCloningProcess cloningProcess = NiCloningProcess();
-    cloningProcess.scale = NiPoint3(1.0f, 1.0f, 1.0f) / *g_fMeleeWeaponHavokScale; // Undo the scaling of the original shape done when creating it
-    cloningProcess.scale *= Config::options.weaponCollisionScale;
-
+    float scaledHandSize = 1.f;
     if (g_isVrikPresent) {
-        cloningProcess.scale *= handSize; // Scale by the vrik hand size
+        scaledHandSize = handSize;
         weaponBodyHandSize = handSize;
     }
 
-    bhkShape *clonedShape = (bhkShape *)NiObject_Clone(shapeWrapper, &cloningProcess);
+    NiPointer<bhkShape> clonedShape = GetScaledWeaponShape(shapeWrapper, scaledHandSize);
+    if (!clonedShape) return;
 
     bhkRigidBodyCinfo cInfo;
     bhkRigidBodyCinfo_ctor(&cInfo);
@@ -785,6 +728,7 @@ void Hand::CreateWeaponCollision(bhkWorld *world)
 
         clonedFromWeaponShape = { rigidBody, rigidBody->hkBody, shapeWrapper, shapeWrapper->shape };
         weaponBody = clonedBody;
+        weaponShape = clonedShape;
         weaponCollidable = weaponBody->hkBody->getCollidableRw();
         weaponCollisionCreatedTime = g_currentFrameTime;
     }
@@ -800,6 +744,7 @@ void Hand::RemoveWeaponCollision(bhkWorld *world)
     hkBool ret;
     hkpWorld_RemoveEntity(world->world, &ret, weaponBody->hkBody);
     weaponBody = nullptr;
+    weaponShape = nullptr; // after the body, which still points at the shape
     weaponCollidable = nullptr;
     clonedFromWeaponShape = {};
 }
@@ -815,6 +760,7 @@ void Hand::RemoveWeaponCollisionFromCurrentWorld()
             }
         }
         weaponBody = nullptr;
+        weaponShape = nullptr;
         weaponCollidable = nullptr;
     }
 }
@@ -1084,7 +1030,7 @@ std::optional<NiTransform> Hand::ComputeInitialObjectTransform(TESObjectREFR *re
     NiPoint3 extents = VectorAbs(HkVectorToNiPoint(aabb.m_max) - HkVectorToNiPoint(aabb.m_min));
     float maxExtent = max(extents.x, max(extents.y, extents.z)) * *g_inverseHavokWorldScale;
 
-    _MESSAGE("%.2f", deltaPos / maxExtent);
+    AsyncLog::Message("%.2f", deltaPos / maxExtent);
     */
 
     attachTransform->scale = currentTransform.scale;
@@ -1189,12 +1135,12 @@ NiPointer<bhkRigidBody> Hand::GetRigidBodyToGrabBasedOnGeometry(const Hand &othe
     std::vector<SkinInstanceRepresentation> visitedSkinInstances{};
     double t = GetTime();
     GetSkinnedTriangles(objRoot, triangles, trianglePartitions, partitionDataMap, visitedSkinInstances);
-    _MESSAGE("Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
+    HIGGS_MESSAGE(Geometry, "Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
 
     std::vector<NiAVObject *> triangleNodes{};
     t = GetTime();
     GetTriangles(objRoot, triangles, triangleNodes);
-    _MESSAGE("Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
+    HIGGS_MESSAGE(Geometry, "Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
 
     // Transform triangles to the object's adjusted transform
     NiTransform inverseCurrent = InverseTransform(originalTransform);
@@ -1210,7 +1156,7 @@ NiPointer<bhkRigidBody> Hand::GetRigidBodyToGrabBasedOnGeometry(const Hand &othe
     int closestTriIndex = -1;
     t = GetTime();
     bool havePointOnGeometry = GetClosestPointOnGraphicsGeometryToLine(triangles, palmPos, palmDirection, triPos, triNormal, closestTriIndex, closestDist);
-    _MESSAGE("Time spent finding closest triangle: %.3f ms", (GetTime() - t) * 1000);
+    HIGGS_MESSAGE(Geometry, "Time spent finding closest triangle: %.3f ms", (GetTime() - t) * 1000);
 
     if (!havePointOnGeometry) {
         return nullptr;
@@ -1397,12 +1343,12 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
         std::vector<SkinInstanceRepresentation> visitedSkinInstances{};
         double t = GetTime();
         GetSkinnedTriangles(objRoot, triangles, trianglePartitions, partitionDataMap, visitedSkinInstances, skinToSpecificNodes ? &nodesToSkinTo : nullptr);
-        _MESSAGE("Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
+        HIGGS_MESSAGE(Geometry, "Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
 
         std::vector<NiAVObject *> triangleNodes{};
         t = GetTime();
         GetTriangles(objRoot, triangles, triangleNodes);
-        _MESSAGE("Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
+        HIGGS_MESSAGE(Geometry, "Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
 
         // Transform triangles to the object's adjusted transform
         NiTransform inverseCurrent = InverseTransform(originalTransform);
@@ -1440,8 +1386,8 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
                 nearbyTriangles.push_back(triangle);
             }
         }
-        _MESSAGE("Time spent filtering triangles: %.3f ms", (GetTime() - tt) * 1000);
-        _MESSAGE("%d / %d triangles within distance", nearbyTriangles.size(), triangles.size());
+        HIGGS_MESSAGE(Geometry, "Time spent filtering triangles: %.3f ms", (GetTime() - tt) * 1000);
+        HIGGS_MESSAGE(Geometry, "%d / %d triangles within distance", (int)nearbyTriangles.size(), (int)triangles.size());
 
         ptPos = triPos;
 
@@ -1481,7 +1427,7 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
 
             startFingerPos += palmToPoint; // Move the finger up to where the hand would be if it was already holding the object
 
-            _DMESSAGE("finger %d", fingerIndex);
+            HIGGS_DMESSAGE(Fingers, "finger %d", fingerIndex);
 
             Intersection intersection;
             bool intersects = GetIntersections(nearbyTriangles, fingerIndex, handScale, startFingerPos, normalWorldspace, zeroAngleVectorWorldspace,
@@ -1520,19 +1466,19 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
 
             if (curveVal < 0) {
                 // It's a negative angle - just open the hand
-                _MESSAGE("%d angle: %.2f", i, curveVal);
+                HIGGS_MESSAGE(Fingers, "%d angle: %.2f", i, curveVal);
                 grabbedFingerValues[i] = 1.f;
             }
             else {
                 // Positive => it's a curve val
-                _MESSAGE("%d curve val: %.2f", i, curveVal);
+                HIGGS_MESSAGE(Fingers, "%d curve val: %.2f", i, curveVal);
                 grabbedFingerValues[i] = curveVal;
             }
 
             grabbedFingerValues[i] = max(0.2f, grabbedFingerValues[i]); // some min value to not overcurl the finger
         }
 
-        _MESSAGE("Geometry processing time: %.3f ms", (GetTime() - t) * 1000);
+        HIGGS_MESSAGE(Geometry, "Geometry processing time: %.3f ms", (GetTime() - t) * 1000);
     }
     else {
         for (int i = 0; i < 5; i++) {
@@ -1631,7 +1577,7 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
             startGrabLerpHandDuration = std::clamp(startGrabLerpHandDuration, Config::options.physicsGrabLerpHandTimeMin, Config::options.physicsGrabLerpHandTimeMax);
         }
 
-        handDeviations.assign(handDeviations.size(), 0.f);
+        handDeviations.Fill(0.f);
 
         for (NiPointer<bhkRigidBody> connectedBody : connectedRigidBodies) {
             hkpEntity_addContactListener(connectedBody->hkBody, isLeft ? &g_leftEntityCollisionListener : &g_rightEntityCollisionListener);
@@ -1686,17 +1632,17 @@ void Hand::TransitionHeld(Hand &other, bhkWorld &world, const NiPoint3 &palmPos,
         NiTransform palmTransformNodeSpace = handTransformNodeSpace;
         palmTransformNodeSpace.pos = handTransformNodeSpace * palmPosHandspace;
 
-        _MESSAGE("");
-        _MESSAGE("HIGGS grab node information");
-        _MESSAGE("Parent:");
-        _MESSAGE(collidableNode->m_name);
-        _MESSAGE("Name:");
-        _MESSAGE(grabNodeOnObjectName.data);
-        _MESSAGE("Translation:");
+        AsyncLog::Message("");
+        AsyncLog::Message("HIGGS grab node information");
+        AsyncLog::Message("Parent:");
+        AsyncLog::Message(collidableNode->m_name);
+        AsyncLog::Message("Name:");
+        AsyncLog::Message(grabNodeOnObjectName.data);
+        AsyncLog::Message("Translation:");
         PrintVector(palmTransformNodeSpace.pos);
-        _MESSAGE("Rotation:");
+        AsyncLog::Message("Rotation:");
         PrintVector(NifskopeMatrixToEuler(palmTransformNodeSpace.rot) * 57.2958f);
-        _MESSAGE("");
+        AsyncLog::Message("");
     }
 
     HiggsPluginAPI::TriggerGrabbedCallbacks(isLeft, selectedObj);
@@ -1740,12 +1686,12 @@ void Hand::TransitionHeldTwoHanded(Hand &other, bhkWorld &world, const NiPoint3
     std::vector<SkinInstanceRepresentation> visitedSkinInstances{};
     double t = GetTime();
     GetSkinnedTriangles(weaponNode, triangles, trianglePartitions, partitionData, visitedSkinInstances);
-    _MESSAGE("Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
+    HIGGS_MESSAGE(Geometry, "Time spent skinning: %.3f ms", (GetTime() - t) * 1000);
 
     std::vector<NiAVObject *> triangleNodes{};
     t = GetTime();
     GetTriangles(weaponNode, triangles, triangleNodes);
-    _MESSAGE("Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
+    HIGGS_MESSAGE(Geometry, "Time spent transforming triangles: %.3f ms", (GetTime() - t) * 1000);
 
     NiPoint3 triPos, triNormal;
     float closestDist = (std::numeric_limits<float>::max)();
@@ -1790,7 +1736,7 @@ void Hand::TransitionHeldTwoHanded(Hand &other, bhkWorld &world, const NiPoint3
 
             startFingerPos += palmToPoint; // Move the finger up to where the hand would be if it was already holding the object
 
-            _DMESSAGE("finger %d", fingerIndex);
+            HIGGS_DMESSAGE(Fingers, "finger %d", fingerIndex);
 
             Intersection intersection;
             bool intersects = GetIntersections(triangles, fingerIndex, handScale, startFingerPos, normalWorldspace, zeroAngleVectorWorldspace,
@@ -1829,19 +1775,19 @@ void Hand::TransitionHeldTwoHanded(Hand &other, bhkWorld &world, const NiPoint3
 
             if (curveVal < 0) {
                 // It's a negative angle - just open the hand
-                _MESSAGE("%d angle: %.2f", i, curveVal);
+                HIGGS_MESSAGE(Fingers, "%d angle: %.2f", i, curveVal);
                 grabbedFingerValues[i] = 1.0f;
             }
             else {
                 // Positive => it's a curve val
-                _MESSAGE("%d curve val: %.2f", i, curveVal);
+                HIGGS_MESSAGE(Fingers, "%d curve val: %.2f", i, curveVal);
                 grabbedFingerValues[i] = curveVal;
             }
 
             grabbedFingerValues[i] = max(0.2f, grabbedFingerValues[i]); // some min value to not overcurl the finger
         }
 
-        _MESSAGE("Geometry processing time: %.3f ms", (GetTime() - t) * 1000);
+        HIGGS_MESSAGE(Geometry, "Geometry processing time: %.3f ms", (GetTime() - t) * 1000);
     }
 
     NiTransform inverseHand = InverseTransform(handTransform);
@@ -1917,11 +1863,7 @@ bool Hand::IsObjectDepositable(TESObjectREFR *refr, NiAVObject *hmdNode, const N
         return false;
     }
 
-    float speed = 0;
-    for (const NiPoint3 &velocity : controllerData.linearVelocities) {
-        speed += VectorLength(velocity);
-    }
-    speed /= std::size(controllerData.linearVelocities);
+    float speed = controllerData.linearVelocities.AverageSpeed();
 
     if (speed < Config::options.shoulderVelocityThreshold) {
         NiPoint3 rightShoulderPos = hmdNode->m_worldTransform * Config::options.rightShoulderHmdOffset;
@@ -1959,11 +1901,7 @@ bool Hand::IsObjectConsumable(TESObjectREFR *refr, NiAVObject *hmdNode, const Ni
         return false;
     }
 
-    float speed = 0;
-    for (const NiPoint3 &velocity : controllerData.linearVelocities) {
-        speed += VectorLength(velocity);
-    }
-    speed /= std::size(controllerData.linearVelocities);
+    float speed = controllerData.linearVelocities.AverageSpeed();
 
     if (speed < Config::options.mouthVelocityThreshold) {
         NiPoint3 mouthPos = hmdNode->m_worldTransform * Config::options.mouthHmdOffset;
@@ -2020,7 +1958,7 @@ UInt32 Hand::SpawnEquippedSelectedObject(TESObjectREFR *selectedObj, float zOffs
 bool Hand::TransitionGrabExternal(TESObjectREFR *refr)
 {
     if (CanGrabObject() && refr) {
-        _MESSAGE("External grab");
+        AsyncLog::Message("External grab");
 
         if (state == State::SelectedClose || state == State::SelectedFar || state == State::SelectionLocked) {
             StopSelectionEffect(selectedObject.handle, selectedObject.shaderNode);
@@ -2055,7 +1993,7 @@ void Hand::GrabExternalObject(Hand &other, bhkWorld &world, TESObjectREFR *selec
     if (state == State::HeldInit) {
         // Set the transform here to kind of skip the HeldInit state
         NiTransform newTransform = handNode->m_worldTransform * desiredNodeTransformHandSpace;
-        UpdateKeyframedNode(collidableNode, newTransform);
+        UpdateKeyframedNode(GetKeyframedNodeInfo(collidableNode), newTransform);
     }
 }
 
@@ -2078,15 +2016,91 @@ NiPointer<NiAVObject> Hand::GetFirstPersonHandNode()
     return isLeft ? player->unk3F0[PlayerCharacter::Node::kNode_LeftHandBone] : player->unk3F0[PlayerCharacter::Node::kNode_RightHandBone];
 }
 
-NiPointer<NiAVObject> Hand::GetThirdPersonHandNode()
+void Hand::UpdateCachedPlayerNodes()
 {
+    UInt32 generation = UpdatePlayerNodesGeneration();
+    if (generation == cachedPlayerNodesGeneration && cachedThirdPersonHandNode && cachedComNode) return;
+    cachedPlayerNodesGeneration = generation;
+
+    cachedThirdPersonHandNode = nullptr;
+    cachedComNode = nullptr;
+
     PlayerCharacter *player = *g_thePlayer;
-    if (!player) return nullptr;
+    if (!player) return;
 
     NiPointer<NiAVObject> rootNode = player->GetNiRootNode(0);
-    if (!rootNode) return nullptr;
+    if (!rootNode) return;
+
+    // If either lookup fails (e.g. the skeleton is still being set up), we'll just try again on the next call
+    static BSFixedString comName("NPC COM [COM ]");
+    cachedThirdPersonHandNode = rootNode->GetObjectByName(&handNodeName.data);
+    cachedComNode = rootNode->GetObjectByName(&comName.data);
+}
+
+NiPointer<NiAVObject> Hand::GetThirdPersonHandNode()
+{
+    UpdateCachedPlayerNodes();
+    return cachedThirdPersonHandNode;
+}
 
-    return rootNode->GetObjectByName(&handNodeName.data);
+NiPointer<NiAVObject> Hand::GetComNode()
+{
+    UpdateCachedPlayerNodes();
+    return cachedComNode;
+}
+
+
+void Hand::ResolveSelection()
+{
+    resolvedSelection.handle = selectedObject.handle;
+    resolvedSelection.collidable = selectedObject.collidable;
+    resolvedSelection.ref = nullptr;
+    resolvedSelection.root = nullptr;
+    resolvedSelection.collidableNode = nullptr;
+
+    if (LookupREFRByHandle(resolvedSelection.handle, resolvedSelection.ref)) {
+        resolvedSelection.root = resolvedSelection.ref->GetNiNode();
+        if (resolvedSelection.collidable) {
+            resolvedSelection.collidableNode = GetNodeFromCollidable(resolvedSelection.collidable);
+        }
+    }
+
+    resolvedSelection.isValid = true;
+}
+
+bool Hand::LookupSelectedObject(NiPointer<TESObjectREFR> &selectedObjOut)
+{
+    // Selecting something else changes the handle, so that doesn't need an explicit invalidation
+    if (!resolvedSelection.isValid || resolvedSelection.handle != selectedObject.handle) {
+        ResolveSelection();
+    }
+    selectedObjOut = resolvedSelection.ref;
+    return selectedObjOut != nullptr;
+}
+
+NiPointer<NiNode> Hand::GetSelectedRootNode()
+{
+    if (!resolvedSelection.isValid || resolvedSelection.handle != selectedObject.handle) {
+        ResolveSelection();
+    }
+    return resolvedSelection.root;
+}
+
+NiPointer<NiAVObject> Hand::GetSelectedCollidableNode()
+{
+    if (!resolvedSelection.isValid || resolvedSelection.handle != selectedObject.handle || resolvedSelection.collidable != selectedObject.collidable) {
+        ResolveSelection();
+    }
+    return resolvedSelection.collidableNode;
+}
+
+KeyframedNodeInfo & Hand::GetKeyframedNodeInfo(NiAVObject *node)
+{
+    if (!keyframedNodeInfo.IsFor(node)) {
+        // Only happens on the first update after grabbing something, or if the held node's 3d was replaced
+        ClassifyKeyframedNode(node, keyframedNodeInfo);
+    }
+    return keyframedNodeInfo;
 }
 
 
@@ -2199,36 +2213,16 @@ float Hand::GetHandSize()
 }
 
 
-NiPoint3 GetMaxVelocity(const std::deque<NiPoint3> &velocities)
+void Hand::GetHandVelocities(NiPoint3 &linearVelocityOut, NiPoint3 &angularVelocityOut)
 {
-    float largestSpeed = -1;
-    int largestIndex = -1;
-    for (int i = 0; i < velocities.size(); i++) {
-        const NiPoint3 &velocity = velocities[i];
-        float speed = VectorLength(velocity);
-        if (speed > largestSpeed) {
-            largestSpeed = speed;
-            largestIndex = i;
+    if (Config::options.throwVelocityEstimationWindow > 0.0) {
+        if (poseHistory.EstimateVelocity(Config::options.throwVelocityEstimationWindow, linearVelocityOut, angularVelocityOut)) {
+            return;
         }
     }
 
-    if (largestIndex == 0) {
-        // Max is the first value
-        return velocities[0];
-    }
-    else if (largestIndex == velocities.size() - 1) {
-        // Max is the last value
-        return velocities[largestIndex];
-    }
-    else {
-        // Regular case - avg 3 values centered at the peak
-        return (velocities[largestIndex - 1] + velocities[largestIndex] + velocities[largestIndex + 1]) / 3;
-    }
-}
-
-NiPoint3 Hand::GetHandVelocity()
-{
-    return GetMaxVelocity(controllerData.linearVelocities);
+    linearVelocityOut = controllerData.linearVelocities.GetMaxVelocity();
+    angularVelocityOut = controllerData.angularVelocities[0];
 }
 
 
@@ -2241,7 +2235,7 @@ void Hand::UpdateHandTransform(NiTransform &worldTransform)
     PlayerCharacter *player = *g_thePlayer;
     if (NiPointer<NiAVObject> clavicle = isLeft ? player->unk3F0[PlayerCharacter::Node::kNode_LeftCavicle] : player->unk3F0[PlayerCharacter::Node::kNode_RightCavicle]) {
         if (std::isnan(worldTransform.pos.x) || std::isnan(worldTransform.pos.y) || std::isnan(worldTransform.pos.z)) {
-            _WARNING("[WARNING] Attempted hand transform contains nans!");
+            AsyncLog::Warning("[WARNING] Attempted hand transform contains nans!");
             return;
         }
 
@@ -2294,6 +2288,7 @@ NiPoint3 Hand::GetPointingVectorWS(NiMatrix33 &handRotation)
 
 void Hand::Update(Hand &other, bhkWorld *world)
 {
+    HIGGS_PROFILE_ZONE("Hand::Update");
     //_MESSAGE("%s:, pose update", name);
 
     PlayerCharacter *player = *g_thePlayer;
@@ -2320,10 +2315,9 @@ void Hand::Update(Hand &other, bhkWorld *world)
     // Skyrim coords: +x: right vector, +y: forward vector, +z: up vector
     NiPoint3 hmdForward = ForwardVector(hmdNode->m_worldTransform.rot);
 
-    static BSFixedString comName("NPC COM [COM ]");
-    NiPointer<NiAVObject> comNode = player->GetNiRootNode(0)->GetObjectByName(&comName.data);
+    NiPointer<NiAVObject> comNode = GetComNode();
     if (!comNode) {
-        _MESSAGE("No COM [COM ] node on player");
+        HIGGS_MESSAGE(General, "No COM [COM ] node on player");
         return;
     }
     NiPointer<bhkRigidBody> comRigidBody = GetRigidBody(comNode);
@@ -2331,7 +2325,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
         playerCollisionGroup = comRigidBody->hkBody->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo >> 16;
     }
     else {
-        _MESSAGE("COM node has no collision object");
+        HIGGS_MESSAGE(General, "COM node has no collision object");
         return;
     }
 
@@ -2351,11 +2345,16 @@ void Hand::Update(Hand &other, bhkWorld *world)
     //}
 
 
+    // Pick up any change to the history length from the config. These are no-ops if the length is the same.
+    playerVelocitiesWorldspace.SetLength(Config::options.velocityHistoryLength);
+    controllerData.linearVelocities.SetLength(Config::options.velocityHistoryLength);
+    controllerData.angularVelocities.SetLength(Config::options.velocityHistoryLength);
+    selectedObject.localLinearVelocities.SetLength(Config::options.velocityHistoryLength);
+
     // Update velocities to this frame
     NiPoint3 playerVelocityWorldspace = (player->pos - prevPlayerPosWorldspace) / *g_deltaTime;
-    playerVelocitiesWorldspace.pop_back();
-    playerVelocitiesWorldspace.push_front(playerVelocityWorldspace);
-    avgPlayerVelocityWorldspace = std::accumulate(playerVelocitiesWorldspace.begin(), playerVelocitiesWorldspace.end(), NiPoint3()) / playerVelocitiesWorldspace.size();
+    playerVelocitiesWorldspace.Push(playerVelocityWorldspace);
+    avgPlayerVelocityWorldspace = playerVelocitiesWorldspace.AverageVelocity();
     avgPlayerSpeedWorldspace = VectorLength(avgPlayerVelocityWorldspace);
 
     if (NiPointer<bhkCharProxyController> controller = GetCharProxyController(*g_thePlayer)) {
@@ -2392,7 +2391,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::GrabFromOtherHand) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
+        if (LookupSelectedObject(selectedObj)) {
             TransitionHeld(other, *world, palmPos, palmVector, selectedObject.point, havokWorldScale, handNode, handSize, selectedObj);
         }
         else {
@@ -2406,8 +2405,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
         }
         else {
             NiPointer<TESObjectREFR> selectedObj;
-            if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-                NiPointer<NiNode> objRoot = selectedObj->GetNiNode();
+            if (LookupSelectedObject(selectedObj)) {
+                NiPointer<NiNode> objRoot = GetSelectedRootNode();
                 if (objRoot && objRoot->m_parent) {
                     if (NiPointer<bhkRigidBody> rigidBody = GetFirstRigidBody(objRoot)) {
                         hkpCollidable *collidable = &rigidBody->hkBody->m_collidable;
@@ -2458,17 +2457,17 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
         bool isSelectedNear = false;
         if (isAllowedToHold) {
-            isSelectedNear = FindCloseObject(world, other, hkPalmPos, palmVector, sphere, isTwoHandedOffhand,
+            isSelectedNear = FindCloseObject(world, other, hkPalmPos, palmVector, isTwoHandedOffhand,
                 closestObj, closestRigidBody, closestPoint);
 
             if (!isSelectedNear && !shouldRestrictPull) {
                 // Nothing close by the hand. Check for stuff farther away
-                FindFarObject(world, other, hkPalmPos, pointingVector, hmdPos * havokWorldScale, hmdForward, sphere,
+                FindFarObject(world, other, hkPalmPos, pointingVector, hmdPos * havokWorldScale, hmdForward,
                     closestObj, closestRigidBody, closestPoint);
             }
         }
         else if (canTwoHand) {
-            if (FindOtherWeapon(world, other, hkPalmPos, palmVector, sphere, closestPoint)) {
+            if (FindOtherWeapon(world, other, hkPalmPos, palmVector, closestPoint)) {
                 closestRigidBody = other.weaponBody;
                 closestObj = nullptr;
             }
@@ -2484,7 +2483,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
             selectedObject.point = HkVectorToNiPoint(closestPoint);
 
             NiPointer<TESObjectREFR> selectedObj;
-            if (!LookupREFRByHandle(selectedObject.handle, selectedObj) || closestObj != selectedObj) {
+            if (!LookupSelectedObject(selectedObj) || closestObj != selectedObj) {
                 if (selectedObj) {
                     // Deselect the old thing if something else was selected
                     StopSelectionEffect(selectedObject.handle, selectedObject.shaderNode);
@@ -2596,7 +2595,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
             }
 
             if (nodeOnWhichToPlayShader) {
-                if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
+                if (LookupSelectedObject(selectedObj)) {
                     if (nodeOnWhichToPlayShader != selectedObject.shaderNode) {
                         // New node, same (or new) object
                         if (selectedObject.handle == prevSelectedHandle) {
@@ -2617,7 +2616,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                     }
                 }
             }
-            else if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
+            else if (LookupSelectedObject(selectedObj)) {
                 // No (actor) node selected but refr is still selected
 
                 NiPointer<NiNode> objRoot = selectedObj->GetNiNode();
@@ -2793,7 +2792,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
         if (state == State::SelectedClose || state == State::SelectedFar) {
             NiPointer<TESObjectREFR> selectedObj;
-            if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
+            if (LookupSelectedObject(selectedObj)) {
 #ifdef _DEBUG
                 NiTransform t;
                 t.pos = selectedObject.point / havokWorldScale;
@@ -2959,8 +2958,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
             }
 
             NiPointer<TESObjectREFR> selectedObj;
-            if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-                if (NiPointer<NiNode> objRoot = selectedObj->GetNiNode()) {
+            if (LookupSelectedObject(selectedObj)) {
+                if (NiPointer<NiNode> objRoot = GetSelectedRootNode()) {
                     if (state == State::SelectionLocked || state == State::LootOtherHand) {
                         if (state == State::SelectionLocked) {
                             float hapticStrength = Config::options.selectionLockedEndHapticStrength;
@@ -2972,12 +2971,12 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
                     if (state == State::HeldInit || state == State::Held || state == State::HeldBody) {
 
-                        NiPoint3 velocityHandComponent = GetHandVelocity();
+                        NiPoint3 velocityHandComponent, handAngularVelocity;
+                        GetHandVelocities(velocityHandComponent, handAngularVelocity);
                         if (VectorLength(velocityHandComponent) > Config::options.throwVelocityThreshold) {
                             velocityHandComponent *= Config::options.throwVelocityBoostFactor;
                         }
 
-                        NiPoint3 handAngularVelocity = controllerData.angularVelocities[0];
                         NiPoint3 angularVelocity = handAngularVelocity * Config::options.angularVelocityMultiplier;
 
                         NiPoint3 tangentialVelocity = { 0, 0, 0 };
@@ -3021,7 +3020,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                             CollectAllGrabbedRigidBodies(objRoot, selectedObject.rigidBody, connectedRigidBodies);
 
                             // Set velocity of the held object more precisely than just using its current velocity
-                            NiPoint3 velocityObjectComponent = GetMaxVelocity(selectedObject.localLinearVelocities);
+                            NiPoint3 velocityObjectComponent = selectedObject.localLinearVelocities.GetMaxVelocity();
                             if (VectorLength(velocityObjectComponent) > Config::options.throwVelocityThreshold) {
                                 velocityObjectComponent *= Config::options.throwVelocityBoostFactor;
                             }
@@ -3129,7 +3128,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                             haptics.QueueHapticEvent(Config::options.shoulderDropHapticStrength, 0, Config::options.shoulderDropHapticFadeTime);
                         }
                         else {
-                            float mass = NiAVObject_GetMass(GetNodeFromCollidable(selectedObject.collidable), 0);
+                            float mass = NiAVObject_GetMass(GetSelectedCollidableNode(), 0);
                             float hapticStrength = min(1.0f, Config::options.grabBaseHapticStrength + Config::options.grabProportionalHapticStrength * max(0.0f, powf(mass, Config::options.grabHapticMassExponent)));
                             haptics.QueueHapticEvent(hapticStrength, 0, Config::options.grabHapticFadeTime);
 
@@ -3185,8 +3184,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::SelectionLocked) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-            if (NiPointer<NiNode> objRoot = selectedObj->GetNiNode()) {
+        if (LookupSelectedObject(selectedObj)) {
+            if (NiPointer<NiNode> objRoot = GetSelectedRootNode()) {
                 hkpMotion *motion = &selectedObject.rigidBody->hkBody->m_motion;
 
                 auto TransitionPulled = [this, &other, &objRoot, &hkPalmPos, motion, selectedObj, handNode, havokWorldScale]()
@@ -3276,7 +3275,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                 NiPointer<bhkRigidBody> closestRigidBody;
                 hkVector4 closestPoint;
 
-                bool isSelectedNear = isAllowedToHold && FindCloseObject(world, other, hkPalmPos, palmVector, sphere, isTwoHandedOffhand,
+                bool isSelectedNear = isAllowedToHold && FindCloseObject(world, other, hkPalmPos, palmVector, isTwoHandedOffhand,
                     closestObj, closestRigidBody, closestPoint);
 
                 // Allow us to go to held if we had the thing locked in from a distance and it came closer
@@ -3316,8 +3315,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::LootOtherHand) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-            if (NiPointer<NiNode> objRoot = selectedObj->GetNiNode()) {
+        if (LookupSelectedObject(selectedObj)) {
+            if (NiPointer<NiNode> objRoot = GetSelectedRootNode()) {
                 if (other.HasHeldObject() && other.selectedObject.rigidBody == selectedObject.rigidBody) {
                     // Other hand is still holding this object
 
@@ -3363,8 +3362,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
         }
         else {
             NiPointer<TESObjectREFR> selectedObj;
-            if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-                NiPointer<NiNode> objRoot = selectedObj->GetNiNode();
+            if (LookupSelectedObject(selectedObj)) {
+                NiPointer<NiNode> objRoot = GetSelectedRootNode();
                 if (objRoot && objRoot->m_parent) {
                     // Transition to grabbed with the newly spawned item
 
@@ -3405,8 +3404,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
         }
         else {
             NiPointer<TESObjectREFR> selectedObj;
-            if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-                NiPointer<NiNode> objRoot = selectedObj->GetNiNode();
+            if (LookupSelectedObject(selectedObj)) {
+                NiPointer<NiNode> objRoot = GetSelectedRootNode();
                 if (objRoot && objRoot->m_parent) {
                     // Transition to pulled with the newly spawned item
 
@@ -3454,8 +3453,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::Pulled) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj)) {
-            if (NiPointer<NiNode> objRoot = selectedObj->GetNiNode()) {
+        if (LookupSelectedObject(selectedObj)) {
+            if (NiPointer<NiNode> objRoot = GetSelectedRootNode()) {
                 hkpMotion *motion = &selectedObject.rigidBody->hkBody->m_motion;
                 NiPoint3 hkObjPos = HkVectorToNiPoint(motion->m_motionState.m_transform.m_translation);
 
@@ -3593,7 +3592,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                 }
 
                 if (std::isnan(palmDirDiffAngle)) {
-                    _WARNING("[WARNING] Two-handed Palm direction difference angle is nan. Setting it to 0.");
+                    AsyncLog::Warning("[WARNING] Two-handed Palm direction difference angle is nan. Setting it to 0.");
                     palmDirDiffAngle = 0.f;
                 }
 
@@ -3652,7 +3651,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
             }
 
             if (std::isnan(desiredTransform.pos.x) || std::isnan(desiredTransform.pos.y) || std::isnan(desiredTransform.pos.z)) {
-                _WARNING("[WARNING] Computed two-handed weapon transform is nan. Using the previous frame's transform.");
+                AsyncLog::Warning("[WARNING] Computed two-handed weapon transform is nan. Using the previous frame's transform.");
                 desiredTransform = twoHandedState.prevWeaponTransform;
             }
 
@@ -3745,8 +3744,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::HeldInit || state == State::Held) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj) && selectedObj->GetNiNode()) {
-            if (NiPointer<NiAVObject> collidableNode = GetNodeFromCollidable(selectedObject.collidable)) {
+        if (LookupSelectedObject(selectedObj) && GetSelectedRootNode()) {
+            if (NiPointer<NiAVObject> collidableNode = GetSelectedCollidableNode()) {
                 if (Config::options.forceGrabbedNodeUpdate) {
                     NiAVObject::ControllerUpdateContext ctx{ 0, 0 };
                     NiAVObject_UpdateNode(collidableNode, &ctx);
@@ -3770,7 +3769,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                         std::optional<NiTransform> advancedTransform = AdvanceTransform(collidableNode->m_worldTransform, desiredTransform, Config::options.grabStartSpeed, Config::options.grabStartAngularSpeed);
                         if (advancedTransform) {
                             // Rotation or position is not yet close enough
-                            UpdateKeyframedNode(collidableNode, *advancedTransform);
+                            UpdateKeyframedNode(GetKeyframedNodeInfo(collidableNode), *advancedTransform);
                         }
                         else {
                             // Both position and rotation are close enough to their final values - we're done
@@ -3781,7 +3780,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                 }
 
                 if (state == State::Held) {
-                    UpdateKeyframedNode(collidableNode, desiredTransform);
+                    UpdateKeyframedNode(GetKeyframedNodeInfo(collidableNode), desiredTransform);
                     if (selectedObj->formType == kFormType_Reference && collidableNode == selectedObj->GetNiNode()) {
                         // Update the refr position and changeflags
                         // Technically we should check the kNotify flag on the collision object, but often it's not set even though it should be.
@@ -3808,8 +3807,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
     if (state == State::HeldBody) {
         NiPointer<TESObjectREFR> selectedObj;
-        if (LookupREFRByHandle(selectedObject.handle, selectedObj) && selectedObj->GetNiNode()) {
-            if (NiPointer<NiAVObject> collidableNode = GetNodeFromCollidable(selectedObject.collidable)) {
+        if (LookupSelectedObject(selectedObj) && GetSelectedRootNode()) {
+            if (NiPointer<NiAVObject> collidableNode = GetSelectedCollidableNode()) {
                 if (Config::options.forceGrabbedNodeUpdate) {
                     NiAVObject::ControllerUpdateContext ctx{ 0, 0 };
                     NiAVObject_UpdateNode(collidableNode, &ctx);
@@ -3831,9 +3830,13 @@ void Hand::Update(Hand &other, bhkWorld *world)
                     }
                 }
 
-                static std::set<NiPointer<bhkRigidBody>> connectedRigidBodies;
-                DeferSetClear connectedRigidBodiesClear(connectedRigidBodies);
-                bool isAttachedToFixed = CollectAllGrabbedRigidBodies(selectedObj->GetNiNode(), selectedObject.rigidBody, connectedRigidBodies);
+                NiPointer<NiNode> objRoot = GetSelectedRootNode();
+                int adjacencyWaves = (selectedObject.isActor && Config::options.doPhysicsGrabPlayerMovementCompensation) ? Config::options.grabbedActorAffectedBoneRadius : 0;
+                if (!IsConstrainedBodySnapshotValid(heldBodySnapshot, objRoot, selectedObject.rigidBody, adjacencyWaves, !isHoldingNonRagdolledActor)) {
+                    BuildConstrainedBodySnapshot(objRoot, selectedObject.rigidBody, adjacencyWaves, !isHoldingNonRagdolledActor, heldBodySnapshot);
+                }
+                const std::vector<NiPointer<bhkRigidBody>> &connectedRigidBodies = heldBodySnapshot.connectedBodies;
+                bool isAttachedToFixed = heldBodySnapshot.isAttachedToFixed;
 
                 if (!isHoldingNonRagdolledActor) {
                     for (bhkRigidBody *connectedBody : connectedRigidBodies) {
@@ -3859,11 +3862,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
                 // If the player is moving, add the player's change in position to the object's position
                 if (Config::options.doPhysicsGrabPlayerMovementCompensation) {
                     if (selectedObject.isActor) {
-                        if (NiPointer<NiAVObject> objRoot = selectedObj->GetNiNode()) {
-                            ForEachAdjacentBody(objRoot, selectedObject.rigidBody, [objRoot, isHoldingNonRagdolledActor](hkpRigidBody *adjacentBody) {
-                                bhkRigidBody *adjacentBodyWrapper = (bhkRigidBody *)adjacentBody->m_userData;
-                                RegisterPlayerSpaceBody(adjacentBodyWrapper, false);
-                            }, Config::options.grabbedActorAffectedBoneRadius);
+                        for (bhkRigidBody *adjacentBody : heldBodySnapshot.adjacentBodies) {
+                            RegisterPlayerSpaceBody(adjacentBody, false);
                         }
                     }
                     else {
@@ -3888,8 +3888,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
 
                 NiPoint3 linearVelocity = HkVectorToNiPoint(selectedObject.rigidBody->hkBody->getLinearVelocity());
                 NiPoint3 localLinearVelocity = linearVelocity - g_prevDeltaVelocity;
-                selectedObject.localLinearVelocities.pop_back();
-                selectedObject.localLinearVelocities.push_front(localLinearVelocity);
+                selectedObject.localLinearVelocities.Push(localLinearVelocity);
 
                 {
                     double elapsedTimeFraction = (g_currentFrameTime - heldTime) / startGrabLerpHandDuration;
@@ -3899,9 +3898,8 @@ void Hand::Update(Hand &other, bhkWorld *world)
                 }
 
                 float handDeviation = VectorLength(m_adjustedHandTransform.pos - m_handTransform.pos);
-                handDeviations.pop_back();
-                handDeviations.push_front(handDeviation);
-                float avgHandDeviation = std::accumulate(handDeviations.begin(), handDeviations.end(), 0.f) / handDeviations.size();
+                handDeviations.Push(handDeviation);
+                float avgHandDeviation = handDeviations.Average();
 
                 bool shouldIgnoreHandDistance = (g_currentFrameTime - heldTime <= Config::options.physicsGrabIgnoreHandDistanceTime) || (g_currentFrameTime - sneakUnsneakTime <= Config::options.sneakUnsneakIgnoreHandDistanceTime);
 
@@ -3928,16 +3926,18 @@ void Hand::Update(Hand &other, bhkWorld *world)
                         hkpPositionConstraintMotor *linearMotor = (hkpPositionConstraintMotor *)constraintData->m_atoms.m_linearMotor0.m_motor;
                         hkpPositionConstraintMotor *angularMotor = (hkpPositionConstraintMotor *)constraintData->m_atoms.m_ragdollMotors.m_motors[0];
 
-                        float angularToLinearForceRatio = Config::options.grabConstraintAngularToLinearForceRatio;
-                        if (fadeInGrabConstraint) {
-                            double elapsedTimeFraction = (g_currentFrameTime - heldTime) / Config::options.grabConstraintFadeInTime;
-                            angularToLinearForceRatio = lerp(Config::options.grabConstraintFadeInStartAngularMaxForceRatio, Config::options.grabConstraintAngularToLinearForceRatio, min(1.0, elapsedTimeFraction));
+                        bool isWeapon = selectedObj->baseForm->formType == kFormType_Weapon;
+                        if (grabMotorProfile.optionsVersion != Config::g_optionsVersion || grabMotorProfile.isActor != selectedObject.isActor || grabMotorProfile.isWeapon != isWeapon) {
+                            BuildGrabMotorProfile(selectedObject.isActor, isWeapon, grabMotorProfile);
                         }
+                        const GrabMotorProfile &profile = grabMotorProfile;
+
+                        float angularToLinearForceRatio = fadeInGrabConstraint ? profile.angularToLinearForceRatioFadeIn.Sample(g_currentFrameTime - heldTime) : profile.angularToLinearForceRatio;
 
                         if (selectedObject.isActor) {
                             float physicsFPS = 1.f / *g_physicsDeltaTime;
-                            linearMotor->m_maxForce = GetMaxForceForFPS(physicsFPS, Config::options.fpsToActorMaxForceMultiplierMapLinear) * Config::options.grabConstraintLinearMaxForceActor;
-                            angularMotor->m_maxForce = GetMaxForceForFPS(physicsFPS, Config::options.fpsToActorMaxForceMultiplierMapAngular) * Config::options.grabConstraintAngularMaxForceActor;
+                            linearMotor->m_maxForce = profile.GetLinearMaxForceActor(physicsFPS);
+                            angularMotor->m_maxForce = profile.GetAngularMaxForceActor(physicsFPS);
 
                             bool isInRagdollState = false;
                             if (Actor *actor = DYNAMIC_CAST(selectedObj, TESObjectREFR, Actor)) {
@@ -3945,44 +3945,34 @@ void Hand::Update(Hand &other, bhkWorld *world)
                             }
 
                             if (isInRagdollState) {
-                                angularMotor->m_tau = Config::options.grabConstraintAngularTauBody;
-                                linearMotor->m_tau = Config::options.grabConstraintLinearTauBody;
-
-                                {
-                                    double elapsedTimeFraction = (g_currentFrameTime - heldTime) / Config::options.physicsGrabLerpTauTimeBody;
-                                    if (elapsedTimeFraction < 1.0) {
-                                        angularMotor->m_tau = lerp(Config::options.grabConstraintAngularTauBodyStart, Config::options.grabConstraintAngularTauBody, elapsedTimeFraction);
-                                        linearMotor->m_tau = lerp(Config::options.grabConstraintLinearTauBodyStart, Config::options.grabConstraintLinearTauBody, elapsedTimeFraction);
-                                    }
-                                }
+                                double elapsedTime = g_currentFrameTime - heldTime;
+                                angularMotor->m_tau = profile.angularTauBody.Sample(elapsedTime);
+                                linearMotor->m_tau = profile.linearTauBody.Sample(elapsedTime);
                             }
                             else {
-                                angularMotor->m_tau = Config::options.grabConstraintAngularTauActor;
-                                linearMotor->m_tau = Config::options.grabConstraintLinearTauActor;
+                                angularMotor->m_tau = profile.angularTauActor;
+                                linearMotor->m_tau = profile.linearTauActor;
                             }
                         }
                         else {
-                            TESForm *baseForm = selectedObj->baseForm;
-                            bool isWeapon = baseForm->formType == kFormType_Weapon;
-
-                            linearMotor->m_maxForce = isWeapon ? Config::options.grabConstraintLinearMaxForceWeapon : Config::options.grabConstraintLinearMaxForce;
+                            linearMotor->m_maxForce = profile.linearMaxForce;
                             angularMotor->m_maxForce = linearMotor->m_maxForce / angularToLinearForceRatio;
 
                             // Technically this is true even if the object is colliding with another part of itself, ex. one half of a book with the other (the book is closed)
                             bool isColliding = (isLeft ? g_leftEntityCollisionListener : g_rightEntityCollisionListener).IsColliding();
 
-                            float angularTauTarget = isColliding ? Config::options.grabConstraintCollidingAngularTau : Config::options.grabConstraintAngularTau;
-                            float linearTauTarget = isColliding ? Config::options.grabConstraintCollidingLinearTau : Config::options.grabConstraintLinearTau;
+                            float angularTauTarget = isColliding ? profile.collidingAngularTau : profile.angularTau;
+                            float linearTauTarget = isColliding ? profile.collidingLinearTau : profile.linearTau;
 
-                            angularMotor->m_tau = AdvanceFloat(angularMotor->m_tau, angularTauTarget, Config::options.grabConstraintTauLerpSpeed);
-                            linearMotor->m_tau = AdvanceFloat(linearMotor->m_tau, linearTauTarget, Config::options.grabConstraintTauLerpSpeed);
+                            angularMotor->m_tau = AdvanceFloat(angularMotor->m_tau, angularTauTarget, profile.tauLerpSpeed);
+                            linearMotor->m_tau = AdvanceFloat(linearMotor->m_tau, linearTauTarget, profile.tauLerpSpeed);
                         }
 
                         if (!selectedObject.isActor) {
                             // Limit the final values of the max forces
                             float mass = selectedObject.rigidBody->hkBody->getMassInv();
                             mass = mass > 0.f ? 1.f / mass : 0.f;
-                            linearMotor->m_maxForce = min(linearMotor->m_maxForce, mass * Config::options.grabConstraintMaxForceToMassRatio);
+                            linearMotor->m_maxForce = min(linearMotor->m_maxForce, mass * profile.maxForceToMassRatio);
                             angularMotor->m_maxForce = min(angularMotor->m_maxForce, linearMotor->m_maxForce / angularToLinearForceRatio);
                         }
 
@@ -3990,13 +3980,13 @@ void Hand::Update(Hand &other, bhkWorld *world)
                         linearMotor->m_minForce = -linearMotor->m_maxForce;
                         angularMotor->m_minForce = -angularMotor->m_maxForce;
 
-                        angularMotor->m_proportionalRecoveryVelocity = Config::options.grabConstraintAngularProportionalRecoveryVelocity;
-                        angularMotor->m_constantRecoveryVelocity = Config::options.grabConstraintAngularConstantRecoveryVelocity;
-                        angularMotor->m_damping = Config::options.grabConstraintAngularDamping;
+                        angularMotor->m_proportionalRecoveryVelocity = profile.angularMotor.proportionalRecoveryVelocity;
+                        angularMotor->m_constantRecoveryVelocity = profile.angularMotor.constantRecoveryVelocity;
+                        angularMotor->m_damping = profile.angularMotor.damping;
 
-                        linearMotor->m_proportionalRecoveryVelocity = Config::options.grabConstraintLinearProportionalRecoveryVelocity;
-                        linearMotor->m_constantRecoveryVelocity = Config::options.grabConstraintLinearConstantRecoveryVelocity;
-                        linearMotor->m_damping = Config::options.grabConstraintLinearDamping;
+                        linearMotor->m_proportionalRecoveryVelocity = profile.linearMotor.proportionalRecoveryVelocity;
+                        linearMotor->m_constantRecoveryVelocity = profile.linearMotor.constantRecoveryVelocity;
+                        linearMotor->m_damping = profile.linearMotor.damping;
                     }
 
                     bhkRigidBody_setActivated(selectedObject.rigidBody, true);
@@ -4009,7 +3999,7 @@ void Hand::Update(Hand &other, bhkWorld *world)
                                 if (BSGeometry *geom = DYNAMIC_CAST(child, NiAVObject, BSGeometry)) {
                                     UInt32 *isOccluded = *(UInt32 **)&geom->unk128;
                                     if (isOccluded) {
-                                        _MESSAGE("%p\t%d", geom, *isOccluded);
+                                        AsyncLog::Message("%p\t%d", geom, *isOccluded);
                                     }
                                 }
                             }
@@ -4075,9 +4065,12 @@ NiTransform g_lastHandTransformm;
 
 void Hand::PreUpdate(Hand &other, bhkWorld *world)
 {
+    HIGGS_PROFILE_ZONE("Hand::PreUpdate");
     PlayerCharacter *player = *g_thePlayer;
     if (!player || !player->GetNiNode()) return;
 
+    ResolveSelection();
+
     NiPointer<NiAVObject> handNode = GetFirstPersonHandNode();
     if (!handNode) return;
 
@@ -4109,12 +4102,20 @@ void Hand::PreUpdate(Hand &other, bhkWorld *world)
 
 void Hand::PostUpdate(Hand &other, bhkWorld *world)
 {
+    HIGGS_PROFILE_ZONE("Hand::PostUpdate");
     PlayerCharacter *player = *g_thePlayer;
     if (!player->GetNiNode()) return;
 
     NiPointer<NiAVObject> handNode = GetFirstPersonHandNode();
     if (!handNode) return;
 
+    if (state != State::HeldInit && state != State::Held && keyframedNodeInfo.node) {
+        keyframedNodeInfo = {}; // don't keep the dropped object's node alive
+    }
+    if (state != State::HeldBody && heldBodySnapshot.root) {
+        heldBodySnapshot = {};
+    }
+
     // Update these after stuff like two-handing hand updates
     UpdateHandCollision(world);
     UpdateWeaponCollision();
@@ -0,0 +1,30 @@
+#include "higgsinterface002.h"
+
+// A message used to fetch HIGGS's interface
+struct HiggsMessage002 {
+    enum { kMessage_GetInterface = 0xF9279A57 }; // Same as for revision 1
+    void * (*GetApiFunction)(unsigned int revisionNumber) = nullptr;
+};
+
+// Stores the API after it has already been fetched
+HiggsPluginAPI::IHiggsInterface002 * g_higgsInterface002 = nullptr;
+
+// Fetches the interface to use from HIGGS
+HiggsPluginAPI::IHiggsInterface002 * HiggsPluginAPI::GetHiggsInterface002(const PluginHandle & pluginHandle, SKSEMessagingInterface * messagingInterface)
+{
+    // If the interface has already been fetched, return the same object
+    if (g_higgsInterface002) {
+        return g_higgsInterface002;
+    }
+
+    // Dispatch a message to get the plugin interface from HIGGS
+    HiggsMessage002 higgsMessage;
+    messagingInterface->Dispatch(pluginHandle, HiggsMessage002::kMessage_GetInterface, (void*)&higgsMessage, sizeof(HiggsMessage002*), "HIGGS");
+    if (!higgsMessage.GetApiFunction) {
+        return nullptr;
+    }
+
+    // Fetch the API for this version of the HIGGS interface. Older versions of HIGGS return null for revisions they don't know.
+    g_higgsInterface002 = static_cast<IHiggsInterface002*>(higgsMessage.GetApiFunction(2));
+    return g_higgsInterface002;
+}
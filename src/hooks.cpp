@@ -20,6 +20,9 @@
 #include "menu_checker.h"
 #include "pluginapi.h"
 #include "draw.h"
+#include "profiler.h"
+#include "physics_scheduler.h"
+#include "async_log.h"
 
 #include <Physics/Collide/Shape/Query/hkpShapeRayCastOutput.h>
 
@@ -233,15 +236,10 @@ typedef void(*_ShaderProperty_SetEffectData)(BSLightingShaderProperty *shaderPro
 void ShaderSetEffectDataHook(BSLightingShaderProperty *shaderProperty, void *effectShaderData, TESEffectShader *shader)
 {
     if (shader == g_rightHand->itemSelectedShader || shader == g_rightHand->itemSelectedShaderOffLimits) {
-        {
-            if (!g_shaderReference) return;
+        if (!g_shaderReference) return;
 
-            std::shared_lock lock(g_shaderNodesLock);
-
-            // We only play the shader on geometry that's in the set
-            if (g_shaderNodes.count(g_shaderReference) == 0) return;
-            if (g_shaderNodes[g_shaderReference].count(g_shaderGeometry) == 0) return;
-        }
+        // We only play the shader on geometry that's in the set
+        if (!IsShaderNodeGeometry(g_shaderReference, g_shaderGeometry)) return;
     }
 
     ((_ShaderProperty_SetEffectData)shaderSetEffectDataHookedFunc.GetUIntPtr())(shaderProperty, effectShaderData);
@@ -313,10 +311,10 @@ bool BSGeometryListCullingProcess_vf_sub_140DA1860_Hook(BSCullingProcess *_this,
             }
 
             if (!wasVisible && isVisible) {
-                _MESSAGE("On:\t%p\t%s", geom, geom->m_name);
+                AsyncLog::Message("On:\t%p\t%s", geom, geom->m_name);
             }
             else if (wasVisible && !isVisible) {
-                _MESSAGE("Off:\t%p\t%s", geom, geom->m_name);
+                AsyncLog::Message("Off:\t%p\t%s", geom, geom->m_name);
             }
         }
     }
@@ -475,6 +473,7 @@ RolloverHandler g_rolloverHandler;
 
 void PostWandUpdateHook()
 {
+    HIGGS_PROFILE_ZONE("PostWandUpdateHook");
     // This hook is on the main thread, so we're kind of okay to do stuff with the Hand as this won't interleave with its Update
     // This hook is also after the VRIK updateUI hook
 
@@ -518,6 +517,7 @@ void PostWandUpdateHook()
 
 void PlayerCharacterUpdateHook()
 {
+    HIGGS_PROFILE_ZONE("PlayerCharacterUpdateHook");
     HiggsPluginAPI::TriggerPreVrikPreHiggsCallbacks();
     Update();
     HiggsPluginAPI::TriggerPreVrikPostHiggsCallbacks();
@@ -526,6 +526,7 @@ void PlayerCharacterUpdateHook()
 
 void PostVRIKPCUpdateHook(NiNode *thirdPersonRoot, NiAVObject::ControllerUpdateContext &ctx)
 {
+    HIGGS_PROFILE_ZONE("PostVRIKPCUpdateHook");
 
     HiggsPluginAPI::TriggerPostVrikPreHiggsCallbacks();
 
@@ -608,6 +609,11 @@ void UpdatePhysicsTimesHook()
 {
     float gameFrametime = *g_secondsSinceLastFrame_GameTime;
 
+    if (Config::options.enableAdaptivePhysicsSteps) {
+        PhysicsStepScheduler::ScheduleFrame(gameFrametime);
+        return;
+    }
+
     float maxPhysicsFrameTime = 1.f / Config::options.minPhysicsFrameRate;
 
     float physicsFrameTime = gameFrametime;
@@ -705,12 +711,20 @@ typedef hkpStepResult(*_hkpWorld_stepDeltaTime)(hkpWorld *_this, float a_delta);
 _hkpWorld_stepDeltaTime bhkWorld_Update_ahkpWorld_stepDeltaTime_Original = 0;
 hkpStepResult PrePhysicsStepHook(ahkpWorld *_this, float a_physicsDeltaTime)
 {
+    HIGGS_PROFILE_ZONE("PhysicsStep");
     HiggsPluginAPI::TriggerPrePhysicsStepCallbacks(_this->m_userData);
 
     PrePhysicsStep(_this->m_userData);
 
+    int numActiveConstraints = Config::options.enableAdaptivePhysicsSteps ? PhysicsStepScheduler::CountActiveConstraints(_this) : 0;
+    double stepStartTime = GetTime();
+
     hkpStepResult ret = bhkWorld_Update_ahkpWorld_stepDeltaTime_Original(_this, a_physicsDeltaTime);
 
+    if (Config::options.enableAdaptivePhysicsSteps) {
+        PhysicsStepScheduler::RecordStep((GetTime() - stepStartTime) * 1000.0, numActiveConstraints);
+    }
+
     PostPhysicsStep(_this->m_userData);
 
     return ret;
@@ -875,7 +889,7 @@ void DoColorPass_NiCamera_FinishAccumulatingPostResolveDepth_Hook(NiCamera *came
     bool draw = true;
     if (draw) {
         if (!g_wasDrawingLastFrame) {
-            _MESSAGE("Draw on");
+            AsyncLog::Message("Draw on");
         }
 
         Draw::StartDraw();
@@ -883,7 +897,7 @@ void DoColorPass_NiCamera_FinishAccumulatingPostResolveDepth_Hook(NiCamera *came
 
     }
     else if (g_wasDrawingLastFrame) {
-        _MESSAGE("Draw off");
+        AsyncLog::Message("Draw off");
     }
 
     g_wasDrawingLastFrame = draw;
@@ -963,7 +977,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(shaderHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("ShaderReferenceEffect ctor hook complete");
+        AsyncLog::Message("ShaderReferenceEffect ctor hook complete");
     }
 
     {
@@ -994,7 +1008,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(pickLinearCastHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Pick linear cast hook complete");
+        AsyncLog::Message("Pick linear cast hook complete");
     }
 
     {
@@ -1022,7 +1036,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(shaderSetEffectDataHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Shader SetEffectShaderData hook complete");
+        AsyncLog::Message("Shader SetEffectShaderData hook complete");
     }
 
     {
@@ -1055,7 +1069,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(shaderCheckFlagsHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Shader check flags hook complete");
+        AsyncLog::Message("Shader check flags hook complete");
     }
 
     {
@@ -1094,7 +1108,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(shaderSetEffectDataInitHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Shader SetEffectShaderDataInit hook complete");
+        AsyncLog::Message("Shader SetEffectShaderDataInit hook complete");
     }
 
     {
@@ -1139,7 +1153,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(getActivateTextHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("GetActivateText hook complete");
+        AsyncLog::Message("GetActivateText hook complete");
     }
 
     {
@@ -1195,7 +1209,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(refreshActivateButtonArtHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("RefreshActivateButtonArt hook complete");
+        AsyncLog::Message("RefreshActivateButtonArt hook complete");
     }
 
     {
@@ -1234,7 +1248,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(postWandUpdateHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Post Wand Update hook complete");
+        AsyncLog::Message("Post Wand Update hook complete");
     }
 
     {
@@ -1271,7 +1285,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(preVRIKPlayerCharacterUpdateHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("PlayerCharacter::Update pre-vrik hook complete");
+        AsyncLog::Message("PlayerCharacter::Update pre-vrik hook complete");
     }
 
     {
@@ -1313,7 +1327,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(updateVRMeleeDataRigidBodyCtorHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("PlayerCharacter::UpdateVRMeleeData bhkRigidBody_ctor hook complete");
+        AsyncLog::Message("PlayerCharacter::UpdateVRMeleeData bhkRigidBody_ctor hook complete");
     }
 
     if (Config::options.enableHavokFix) {
@@ -1352,7 +1366,7 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write5Branch(updatePhysicsTimesHookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("Update Physics Times hook complete");
+        AsyncLog::Message("Update Physics Times hook complete");
     }
 
     {
@@ -1407,46 +1421,46 @@ void PerformHooks(void)
 
         g_branchTrampoline.Write6Branch(bhkCollisionFilter_CompareFilterInfo_HookLoc.GetUIntPtr(), uintptr_t(code.getCode()));
 
-        _MESSAGE("bhkCollisionFilter::CompareFilterInfo hook complete");
+        AsyncLog::Message("bhkCollisionFilter::CompareFilterInfo hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(postVRIKPlayerCharacterUpdateHookLoc.GetUIntPtr(), uintptr_t(PostVRIKPCUpdateHook));
-        _MESSAGE("PlayerCharacter::Update post-vrik hook complete");
+        AsyncLog::Message("PlayerCharacter::Update post-vrik hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(prePhysicsStepHookLoc.GetUIntPtr(), uintptr_t(PrePhysicsStepHook));
         bhkWorld_Update_ahkpWorld_stepDeltaTime_Original = (_hkpWorld_stepDeltaTime)originalFunc;
-        _MESSAGE("Pre-physics-step hook complete");
+        AsyncLog::Message("Pre-physics-step hook complete");
     }
 
     if (!Config::options.disableSelectionBeam) {
         UInt64 nops = 0x9090909090909090;
         SafeWriteBuf(hideSpellOriginLoc.GetUIntPtr(), &nops, 7);
-        _MESSAGE("NOP'd out SpellOrigin hide");
+        AsyncLog::Message("NOP'd out SpellOrigin hide");
     }
 
     if (Config::options.disableVanillaGrab) {
         UInt8 ret = 0xC3;
         SafeWrite8(startGrabObjectLoc.GetUIntPtr(), ret);
-        _MESSAGE("ret'd out PlayerCharacter::StartGrabObject");
+        AsyncLog::Message("ret'd out PlayerCharacter::StartGrabObject");
     }
 
     if (Config::options.treatHandCollisionAsBelongingToPlayer) {
         g_branchTrampoline.Write5Call(GetRefFromCollidable_GetNodeFromCollidable_HookLoc.GetUIntPtr(), uintptr_t(GetRefFromCollidable_GetNodeFromCollidable_Hook));
-        _MESSAGE("GetRefFromCollidable GetNodeFromCollidable hook complete");
+        AsyncLog::Message("GetRefFromCollidable GetNodeFromCollidable hook complete");
     }
 
     if (Config::options.allowAllPlayerCollisionForTriggers) {
         g_branchTrampoline.Write5Call(TriggerEntry_RegisterOverLap_Actor_IsInRagdollState_HookLoc.GetUIntPtr(), uintptr_t(TriggerEntry_RegisterOverLap_Actor_IsInRagdollState_Hook));
-        _MESSAGE("TriggerEntry::RegisterOverLap Actor::IsInRagdollState hook complete");
+        AsyncLog::Message("TriggerEntry::RegisterOverLap Actor::IsInRagdollState hook complete");
     }
 
     {
         UInt64 bytes = 0x00000060B9; // mov ecx, 0x60
         SafeWriteBuf(allocMeleeRigidBodySizeLoc.GetUIntPtr(), &bytes, 5);
-        _MESSAGE("Patched allocation for melee rigidbody to allocate 0x60 bytes instead of 0x40");
+        AsyncLog::Message("Patched allocation for melee rigidbody to allocate 0x60 bytes instead of 0x40");
     }
 
     {
@@ -1462,41 +1476,41 @@ void PerformHooks(void)
 
     {
         g_branchTrampoline.Write5Call(ArrowProjectile_AddImpact_bhkCollisionObject_GetRigidBody_HookLoc.GetUIntPtr(), uintptr_t(ArrowProjectile_AddImpact_bhkCollisionObject_GetRigidBody_Hook));
-        _MESSAGE("ArrowProjectile::AddImpact bhkCollisionObject::GetRigidBody hook complete");
+        AsyncLog::Message("ArrowProjectile::AddImpact bhkCollisionObject::GetRigidBody hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(Actor_Jump_bhkCharacterController_SetJumping_HookLoc.GetUIntPtr(), uintptr_t(Actor_Jump_bhkCharacterController_SetJumping_Hook));
         Actor_Jump_bhkCharacterController_SetJumping_Original = (_Actor_Jump_bhkCharacterController_SetJumping)originalFunc;
-        _MESSAGE("Actor::Jump bhkCharacterController::SetJumping hook complete");
+        AsyncLog::Message("Actor::Jump bhkCharacterController::SetJumping hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(PlayerCharacter_VRUpdate_PlayerCharacter_UpdateHands_HookLoc.GetUIntPtr(), uintptr_t(PlayerCharacter_VRUpdate_PlayerCharacter_UpdateHands_Hook));
         PlayerCharacter_VRUpdate_PlayerCharacter_UpdateHands_Original = (_PlayerCharacter_VRUpdate_PlayerCharacter_UpdateHands)originalFunc;
-        _MESSAGE("PlayerCharacter::VRUpdate PlayerCharacter::UpdateHands hook complete");
+        AsyncLog::Message("PlayerCharacter::VRUpdate PlayerCharacter::UpdateHands hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(Actor_UpdateMovement_GetCharacterController_HookLoc.GetUIntPtr(), uintptr_t(Actor_UpdateMovement_GetCharacterController_Hook));
         Actor_GetCharacterController_Original = (_Actor_GetCharacterController)originalFunc;
-        _MESSAGE("Actor::ApplyMovementDelta hook complete");
+        AsyncLog::Message("Actor::ApplyMovementDelta hook complete");
     }
 
     {
         std::uintptr_t originalFunc = Write5Call(bhkLinearCaster_linearCast_hkpWorld_linearCast_HookLoc.GetUIntPtr(), uintptr_t(bhkLinearCaster_linearCast_hkpWorld_linearCast_Hook));
         g_original_bhkLinearCaster_linearCast_hkpWorld_linearCast = (_hkpWorld_LinearCast)originalFunc;
-        _MESSAGE("bhkLinearCaster::linearCast hkpWorld::linearCast hook complete");
+        AsyncLog::Message("bhkLinearCaster::linearCast hkpWorld::linearCast hook complete");
     }
 
     {
         Write5Call(PlayerCharacter_UpdateHands_UpdateClavicleToTransformHand_LeftHand_HookLoc.GetUIntPtr(), uintptr_t(PlayerCharacter_UpdateHands_UpdateClavicleToTransformHand_Hook));
-        _MESSAGE("PlayerCharacter::UpdateHands UpdateClavicleToTransformHand LeftHand hook complete");
+        AsyncLog::Message("PlayerCharacter::UpdateHands UpdateClavicleToTransformHand LeftHand hook complete");
     }
 
     {
         Write5Call(PlayerCharacter_UpdateHands_UpdateClavicleToTransformHand_RightHand_HookLoc.GetUIntPtr(), uintptr_t(PlayerCharacter_UpdateHands_UpdateClavicleToTransformHand_Hook));
-        _MESSAGE("PlayerCharacter::UpdateHands UpdateClavicleToTransformHand RightHand hook complete");
+        AsyncLog::Message("PlayerCharacter::UpdateHands UpdateClavicleToTransformHand RightHand hook complete");
     }
 
     {
@@ -1513,7 +1527,7 @@ void PerformHooks(void)
     {
         std::uintptr_t originalFunc = Write5Call(DoColorPass_NiCamera_FinishAccumulatingPostResolveDepth_HookLoc.GetUIntPtr(), uintptr_t(DoColorPass_NiCamera_FinishAccumulatingPostResolveDepth_Hook));
         DoColorPass_NiCamera_FinishAccumulatingPostResolveDepth_Original = (_NiCamera_FinishAccumulatingPostResolveDepth)originalFunc;
-        _MESSAGE("DoColorPass NiCamera::FinishAccumulatingPostResolveDepth hook complete");
+        AsyncLog::Message("DoColorPass NiCamera::FinishAccumulatingPostResolveDepth hook complete");
     }
 #endif // _DEBUG
 }
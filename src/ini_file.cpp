@@ -0,0 +1,122 @@
+#include <cctype>
+#include <fstream>
+#include <iterator>
+
+#include "ini_file.h"
+
+
+static std::string_view Trim(std::string_view s)
+{
+    const char *whitespace = " \t\r\n";
+    size_t start = s.find_first_not_of(whitespace);
+    if (start == std::string_view::npos) return {};
+    size_t end = s.find_last_not_of(whitespace);
+    return s.substr(start, end - start + 1);
+}
+
+static void AppendLower(std::string &out, std::string_view s)
+{
+    for (char c : s) {
+        out.push_back((char)std::tolower((unsigned char)c));
+    }
+}
+
+bool IniFile::Load(const std::string &path)
+{
+    Clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Parse(text);
+    return true;
+}
+
+void IniFile::Clear()
+{
+    entries.clear();
+    index.clear();
+}
+
+void IniFile::Parse(std::string_view text)
+{
+    Clear();
+
+    std::string_view section;
+    int lineNumber = 0;
+
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+
+        std::string_view line = Trim(text.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+        ++lineNumber;
+
+        if (line.empty() || line[0] == ';') continue;
+
+        if (line[0] == '[') {
+            size_t close = line.find(']');
+            section = Trim(line.substr(1, close == std::string_view::npos ? std::string_view::npos : close - 1));
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string_view::npos) continue;
+
+        std::string_view key = Trim(line.substr(0, equals));
+        std::string_view value = Trim(line.substr(equals + 1));
+        if (key.empty()) continue;
+
+        // Matching quotes around the whole value are removed, same as GetPrivateProfileString
+        if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+            value = value.substr(1, value.size() - 2);
+        }
+
+        auto [it, isNew] = index.try_emplace(MakeIndexKey(section, key), entries.size());
+        if (!isNew) continue; // the first one wins
+
+        entries.push_back({ std::string(section), std::string(key), std::string(value), lineNumber });
+    }
+}
+
+const std::string * IniFile::Find(std::string_view section, std::string_view key) const
+{
+    auto it = index.find(MakeIndexKey(section, key));
+    if (it == index.end()) return nullptr;
+
+    const Entry &entry = entries[it->second];
+    entry.isRead = true;
+    return &entry.value;
+}
+
+std::vector<const IniFile::Entry *> IniFile::GetUnreadEntries(std::string_view section) const
+{
+    std::string lowerSection;
+    AppendLower(lowerSection, section);
+
+    std::vector<const Entry *> unread;
+    std::string entrySection;
+    for (const Entry &entry : entries) {
+        if (entry.isRead) continue;
+
+        entrySection.clear();
+        AppendLower(entrySection, entry.section);
+        if (entrySection == lowerSection) {
+            unread.push_back(&entry);
+        }
+    }
+    return unread;
+}
+
+std::string IniFile::MakeIndexKey(std::string_view section, std::string_view key)
+{
+    std::string indexKey;
+    indexKey.reserve(section.size() + key.size() + 1);
+    AppendLower(indexKey, section);
+    indexKey.push_back(']'); // can't be part of a section name
+    AppendLower(indexKey, key);
+    return indexKey;
+}
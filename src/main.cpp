@@ -41,6 +41,8 @@
 #include "main.h"
 #include "finger_curves.h"
 #include "draw.h"
+#include "profiler.h"
+#include "async_log.h"
 
 #include <Physics/Dynamics/World/Extensions/hkpWorldExtension.h>
 
@@ -68,8 +70,6 @@ bool g_isActivateBoundToGrip = false;
 Hand *g_rightHand = nullptr;
 Hand *g_leftHand = nullptr;
 
-std::unordered_map<ShaderReferenceEffect *, std::unordered_set<BSGeometry *>> g_shaderNodes{};
-
 PlayingShader g_playingShaders[2]{};
 std::unordered_map<NiAVObject *, NiPointer<ShaderReferenceEffect>> g_effectDataMap{};
 
@@ -88,7 +88,7 @@ bool TryHook()
     if (g_trampoline) {
         void* branch = g_trampoline->AllocateFromBranchPool(g_pluginHandle, TRAMPOLINE_SIZE);
         if (!branch) {
-            _ERROR("couldn't acquire branch trampoline from SKSE. this is fatal. skipping remainder of init process.");
+            AsyncLog::Error("couldn't acquire branch trampoline from SKSE. this is fatal. skipping remainder of init process.");
             return false;
         }
 
@@ -96,7 +96,7 @@ bool TryHook()
 
         void* local = g_trampoline->AllocateFromLocalPool(g_pluginHandle, TRAMPOLINE_SIZE);
         if (!local) {
-            _ERROR("couldn't acquire codegen buffer from SKSE. this is fatal. skipping remainder of init process.");
+            AsyncLog::Error("couldn't acquire codegen buffer from SKSE. this is fatal. skipping remainder of init process.");
             return false;
         }
 
@@ -104,12 +104,12 @@ bool TryHook()
     }
     else {
         if (!g_branchTrampoline.Create(TRAMPOLINE_SIZE)) {
-            _ERROR("couldn't create branch trampoline. this is fatal. skipping remainder of init process.");
+            AsyncLog::Error("couldn't create branch trampoline. this is fatal. skipping remainder of init process.");
             return false;
         }
         if (!g_localTrampoline.Create(TRAMPOLINE_SIZE, nullptr))
         {
-            _ERROR("couldn't create codegen buffer. this is fatal. skipping remainder of init process.");
+            AsyncLog::Error("couldn't create codegen buffer. this is fatal. skipping remainder of init process.");
             return false;
         }
     }
@@ -143,6 +143,8 @@ void FillControllerVelocities(NiAVObject *hmdNode, vr_src::TrackedDevicePose_t*
                     bool isRightConnected = vrSystem->IsTrackedDeviceConnected(rightIndex);
                     bool isLeftConnected = vrSystem->IsTrackedDeviceConnected(leftIndex);
 
+                    double poseTime = GetTime();
+
                     for (int i = hmdIndex + 1; i < unGamePoseArrayCount; i++) {
                         if (i == rightIndex && isRightConnected) {
                             vr_src::TrackedDevicePose_t &pose = pGamePoseArray[i];
@@ -166,16 +168,15 @@ void FillControllerVelocities(NiAVObject *hmdNode, vr_src::TrackedDevicePose_t*
                                 NiPoint3 openvrVelocity = { pose.vVelocity.v[0], pose.vVelocity.v[1], pose.vVelocity.v[2] };
                                 NiPoint3 skyrimVelocity = { openvrVelocity.x, -openvrVelocity.z, openvrVelocity.y };
                                 NiPoint3 velocityWorldspace = openvrToSkyrimWorldTransform * skyrimVelocity;
-                                g_rightHand->controllerData.linearVelocities.pop_back();
-                                g_rightHand->controllerData.linearVelocities.push_front(velocityWorldspace);
+                                g_rightHand->controllerData.linearVelocities.Push(velocityWorldspace);
 
                                 g_rightHand->controllerData.Recompute();
 
                                 NiPoint3 openvrAngularVelocity = { pose.vAngularVelocity.v[0], pose.vAngularVelocity.v[1], pose.vAngularVelocity.v[2] };
                                 NiPoint3 skyrimAngularVelocity = { openvrAngularVelocity.x, -openvrAngularVelocity.z, openvrAngularVelocity.y };
                                 NiPoint3 angularVelocityWorldspace = openvrToSkyrimWorldTransform * skyrimAngularVelocity;
-                                g_rightHand->controllerData.angularVelocities.pop_back();
-                                g_rightHand->controllerData.angularVelocities.push_front(angularVelocityWorldspace);
+                                g_rightHand->controllerData.angularVelocities.Push(angularVelocityWorldspace);
+                                g_rightHand->poseHistory.Push({ poseTime, velocityWorldspace, angularVelocityWorldspace });
                             }
                         }
                         else if (i == leftIndex && isLeftConnected) {
@@ -184,16 +185,15 @@ void FillControllerVelocities(NiAVObject *hmdNode, vr_src::TrackedDevicePose_t*
                                 NiPoint3 openvrVelocity = { pose.vVelocity.v[0], pose.vVelocity.v[1], pose.vVelocity.v[2] };
                                 NiPoint3 skyrimVelocity = { openvrVelocity.x, -openvrVelocity.z, openvrVelocity.y };
                                 NiPoint3 velocityWorldspace = openvrToSkyrimWorldTransform * skyrimVelocity;
-                                g_leftHand->controllerData.linearVelocities.pop_back();
-                                g_leftHand->controllerData.linearVelocities.push_front(velocityWorldspace);
+                                g_leftHand->controllerData.linearVelocities.Push(velocityWorldspace);
 
                                 g_leftHand->controllerData.Recompute();
 
                                 NiPoint3 openvrAngularVelocity = { pose.vAngularVelocity.v[0], pose.vAngularVelocity.v[1], pose.vAngularVelocity.v[2] };
                                 NiPoint3 skyrimAngularVelocity = { openvrAngularVelocity.x, -openvrAngularVelocity.z, openvrAngularVelocity.y };
                                 NiPoint3 angularVelocityWorldspace = openvrToSkyrimWorldTransform * skyrimAngularVelocity;
-                                g_leftHand->controllerData.angularVelocities.pop_back();
-                                g_leftHand->controllerData.angularVelocities.push_front(angularVelocityWorldspace);
+                                g_leftHand->controllerData.angularVelocities.Push(angularVelocityWorldspace);
+                                g_leftHand->poseHistory.Push({ poseTime, velocityWorldspace, angularVelocityWorldspace });
                             }
                         }
                     }
@@ -271,9 +271,101 @@ void UpdateSpeedReduction()
 NiPoint3 g_prevDeltaVelocity{};
 NiPoint3 g_prevDeltaVelocityWithVrikSmoothingOnly{};
 
-std::set<NiPointer<bhkRigidBody>> g_playerSpaceBodies{};
-std::unordered_set<bhkRigidBody *> g_prevPlayerSpaceBodies{};
-std::unordered_set<bhkRigidBody *> g_playerSpaceBodiesShouldNotWarp{};
+// The bodies that move along with the player during one frame, in registration order.
+// Duplicates are merged through an open-addressed index that is cleared by bumping its generation, so once the arrays have grown to fit, nothing here allocates.
+struct PlayerSpaceBodyList
+{
+    enum Flags : UInt8
+    {
+        kFlag_NoWarp = 1 << 0,
+        kFlag_Removed = 1 << 1, // removed from the world since it was registered
+    };
+
+    struct Entry
+    {
+        bhkRigidBody *body; // kept alive by references while the list is current
+        UInt8 flags;
+    };
+
+    struct IndexSlot
+    {
+        bhkRigidBody *body = nullptr;
+        UInt32 generation = 0; // the slot is empty unless this matches the list's generation
+        UInt32 entryIndex = 0;
+    };
+
+    std::vector<Entry> entries{};
+    std::vector<NiPointer<bhkRigidBody>> references{}; // dropped once the list is only used to look up last frame's bodies
+    std::vector<IndexSlot> index = std::vector<IndexSlot>(64); // size is always a power of 2
+    UInt32 generation = 1;
+
+    IndexSlot & FindSlot(bhkRigidBody *body)
+    {
+        size_t mask = index.size() - 1;
+        size_t i = ((UInt64)body >> 4) * 0x9E3779B97F4A7C15ull >> 32;
+        while (true) {
+            IndexSlot &slot = index[i & mask];
+            if (slot.generation != generation || slot.body == body) return slot;
+            ++i;
+        }
+    }
+
+    void Add(bhkRigidBody *body, bool allowWarp)
+    {
+        if ((entries.size() + 1) * 2 > index.size()) {
+            Grow();
+        }
+
+        UInt8 flags = allowWarp ? 0 : kFlag_NoWarp;
+
+        IndexSlot &slot = FindSlot(body);
+        if (slot.generation == generation) {
+            // Already registered this frame. If anything doesn't want it warped, it isn't.
+            entries[slot.entryIndex].flags |= flags;
+            return;
+        }
+
+        slot = { body, generation, UInt32(entries.size()) };
+        entries.push_back({ body, flags });
+        references.push_back(body);
+    }
+
+    bool Contains(bhkRigidBody *body)
+    {
+        IndexSlot &slot = FindSlot(body);
+        return slot.generation == generation && !(entries[slot.entryIndex].flags & kFlag_Removed);
+    }
+
+    void Grow()
+    {
+        index.assign(index.size() * 2, {});
+        generation = 1;
+        for (UInt32 i = 0; i < entries.size(); i++) {
+            FindSlot(entries[i].body) = { entries[i].body, generation, i };
+        }
+    }
+
+    void ReleaseReferences()
+    {
+        references.clear();
+    }
+
+    void Clear()
+    {
+        entries.clear();
+        references.clear();
+        if (++generation == 0) {
+            // Wrapped around, so old slots could look valid again
+            index.assign(index.size(), {});
+            generation = 1;
+        }
+    }
+};
+
+// Double buffered, so that last frame's bodies can still be queried after they've been simulated.
+// The previous frame's list only compares pointers, so it doesn't keep removed or unloaded bodies alive. Both are leaked, since they hold NiPointers.
+PlayerSpaceBodyList *g_playerSpaceBodies = new PlayerSpaceBodyList;
+PlayerSpaceBodyList *g_prevPlayerSpaceBodies = new PlayerSpaceBodyList;
 
 NiTransform g_prevNextRoomTransform{};
 NiTransform g_prevRoomTransform{};
@@ -286,6 +378,7 @@ struct DampedBodyData
     double endTime;
 };
 std::map<NiPointer<bhkRigidBody>, DampedBodyData> g_dampedBodyData{};
+DeadlineScheduler<bhkRigidBody *> g_dampedBodyExpiry{};
 
 void AddDampedBody(bhkRigidBody *body)
 {
@@ -295,7 +388,9 @@ void AddDampedBody(bhkRigidBody *body)
 
         hkpMotion *motion = body->hkBody->getMotion();
 
-        g_dampedBodyData[body] = { motion->m_motionState.m_linearDamping, motion->m_motionState.m_angularDamping, g_currentFrameTime + Config::options.grabFreezeNearbyVelocityTime };
+        double endTime = g_currentFrameTime + Config::options.grabFreezeNearbyVelocityTime;
+        g_dampedBodyData[body] = { motion->m_motionState.m_linearDamping, motion->m_motionState.m_angularDamping, endTime };
+        g_dampedBodyExpiry.Schedule(body, endTime);
 
         motion->m_motionState.m_linearDamping = hkHalf(Config::options.nearbyGrabLinearDamping);
         motion->m_motionState.m_angularDamping = hkHalf(Config::options.nearbyGrabAngularDamping);
@@ -303,6 +398,7 @@ void AddDampedBody(bhkRigidBody *body)
     else {
         // Already damped, just extend the time
         it->second.endTime = g_currentFrameTime + Config::options.grabFreezeNearbyVelocityTime;
+        g_dampedBodyExpiry.Schedule(body, it->second.endTime);
     }
 }
 
@@ -310,16 +406,12 @@ void ClearStaleDampedBodies(bhkWorld *world)
 {
     static std::vector<std::pair<NiPointer<bhkRigidBody>, DampedBodyData>> toRemove{};
 
-    for (auto &it = g_dampedBodyData.begin(); it != g_dampedBodyData.end();) {
-        auto [body, data] = *it;
-        if (g_currentFrameTime > data.endTime) {
+    g_dampedBodyExpiry.PopExpired(g_currentFrameTime, [](bhkRigidBody *body) {
+        if (auto it = g_dampedBodyData.find(body); it != g_dampedBodyData.end()) {
             toRemove.push_back(*it);
-            it = g_dampedBodyData.erase(it);
-        }
-        else {
-            ++it;
+            g_dampedBodyData.erase(it);
         }
-    }
+    });
 
     if (!toRemove.empty()) {
         BSWriteLocker lock(&world->worldLock);
@@ -338,16 +430,12 @@ void ClearStaleDampedBodies(bhkWorld *world)
 
 void RegisterPlayerSpaceBody(bhkRigidBody *body, bool allowWarp)
 {
-    g_playerSpaceBodies.insert(body);
-
-    if (!allowWarp) {
-        g_playerSpaceBodiesShouldNotWarp.insert(body);
-    }
+    g_playerSpaceBodies->Add(body, allowWarp);
 }
 
 bool WasPlayerSpaceBodyLastFrame(bhkRigidBody *body)
 {
-    return g_prevPlayerSpaceBodies.contains(body);
+    return g_prevPlayerSpaceBodies->Contains(body);
 }
 
 
@@ -370,6 +458,7 @@ float g_prevVrikSmoothingOffset = 0.f;
 
 void SimulatePlayerSpace(bhkWorld *world)
 {
+    HIGGS_PROFILE_ZONE("SimulatePlayerSpace");
     //_MESSAGE("%d SimulatePlayerSpace", *g_currentFrameCounter);
 
     // At the time this is called (in ApplyMovementDelta), the charcontroller has gotten a new position, but the player character's position won't be updated until the end of the frame (after rendering).
@@ -413,9 +502,11 @@ void SimulatePlayerSpace(bhkWorld *world)
         BSWriteLocker lock(&world->worldLock);
 
         // There is potential for a body to be removed from the world between frames, or between being added to g_playerSpaceBodies and this call.
-        std::erase_if(g_playerSpaceBodies, [](const NiPointer<bhkRigidBody> &body) {
-            return !body->hkBody->isAddedToWorld();
-        });
+        for (PlayerSpaceBodyList::Entry &entry : g_playerSpaceBodies->entries) {
+            if (!entry.body->hkBody->isAddedToWorld()) {
+                entry.flags |= PlayerSpaceBodyList::kFlag_Removed;
+            }
+        }
 
         NiTransform currentRoomTransform = roomNode->m_worldTransform;
         currentRoomTransform.pos *= *g_havokWorldScale;
@@ -430,7 +521,10 @@ void SimulatePlayerSpace(bhkWorld *world)
         bool actuallyDoWarp = doWarp || g_prevDoWarp;
 
         if (g_prevVelocityAdded) {
-            for (bhkRigidBody *body : g_playerSpaceBodies) {
+            for (PlayerSpaceBodyList::Entry &entry : g_playerSpaceBodies->entries) {
+                if (entry.flags & PlayerSpaceBodyList::kFlag_Removed) continue;
+                bhkRigidBody *body = entry.body;
+
                 // first subtract the previous velocity
                 if (IsMoveableEntity(body->hkBody)) {
                     // Keyframed rigidBodies (like the hands) get their velocity zeroed when they step, so don't subtract anything
@@ -450,25 +544,29 @@ void SimulatePlayerSpace(bhkWorld *world)
                 NiTransform currentRoomT = nextRoomTransform;
                 currentRoomT.pos *= *g_havokWorldScale;
 
-                for (bhkRigidBody *body : g_playerSpaceBodies) {
-                    if (g_playerSpaceBodiesShouldNotWarp.contains(body)) {
-                        continue;
-                    }
+                // Taking each body into the previous room space and back out of the current one is the same transform for all of them, so compute it once
+                NiTransform warpTransform = currentRoomT * InverseTransform(prevRoomT);
+                warpTransform.pos.z += (vrikZoffset - g_prevVrikOffset) * *g_havokWorldScale;
 
-                    NiTransform currentTransform{};
-                    currentTransform.pos = HkVectorToNiPoint(body->hkBody->getPosition());
-                    currentTransform.rot = QuaternionToMatrix(HkQuatToNiQuat(body->hkBody->getRotation()));
+                hkTransform hkWarpTransform = NiTransformTohkTransform(warpTransform, false);
+                hkQuaternion hkWarpRotation = NiQuatToHkQuat(MatrixToQuaternion(warpTransform.rot));
+                hkSimdReal hkWarpScale = warpTransform.scale;
 
-                    NiTransform currentRoomSpace = InverseTransform(prevRoomT) * currentTransform;
+                for (PlayerSpaceBodyList::Entry &entry : g_playerSpaceBodies->entries) {
+                    if (entry.flags & (PlayerSpaceBodyList::kFlag_NoWarp | PlayerSpaceBodyList::kFlag_Removed)) continue;
+                    bhkRigidBody *body = entry.body;
 
-                    NiTransform newTransform = currentRoomT * currentRoomSpace;
-                    newTransform.pos.z += (vrikZoffset - g_prevVrikOffset) * *g_havokWorldScale;
+                    const hkVector4 &currentPos = body->hkBody->getPosition();
 
-                    NiPoint3 deltaPos = newTransform.pos - currentTransform.pos;
+                    hkVector4 scaledPos; scaledPos.setMul4(hkWarpScale, currentPos);
+                    hkVector4 newPos; newPos.setTransformedPos(hkWarpTransform, scaledPos);
 
-                    if (VectorLength(deltaPos) > 0.001f) {
+                    hkVector4 deltaPos; deltaPos.setSub4(newPos, currentPos);
+
+                    if (deltaPos.length3() > 0.001f) {
+                        hkQuaternion newRot; newRot.setMul(hkWarpRotation, body->hkBody->getRotation());
                         bhkRigidBody_setActivated(body, true);
-                        bhkEntity_setPositionAndRotation(body, NiPointToHkVector(newTransform.pos), NiQuatToHkQuat(MatrixToQuaternion(newTransform.rot))); // do NOT use the vfunc here, because the vfunc would apply bhkRigidBodyT transformations
+                        bhkEntity_setPositionAndRotation(body, newPos, newRot); // do NOT use the vfunc here, because the vfunc would apply bhkRigidBodyT transformations
                     }
 
                     recollideBodies.push_back(body->hkBody);
@@ -486,7 +584,10 @@ void SimulatePlayerSpace(bhkWorld *world)
             g_prevVelocityAdded = false;
         }
         else {
-            for (bhkRigidBody *body : g_playerSpaceBodies) {
+            for (PlayerSpaceBodyList::Entry &entry : g_playerSpaceBodies->entries) {
+                if (entry.flags & PlayerSpaceBodyList::kFlag_Removed) continue;
+                bhkRigidBody *body = entry.body;
+
                 // add the new velocity
                 // Note: We set the velocity of the hands here too, but it doesn't matter since we're overwriting them right after this
                 body->hkBody->m_motion.m_linearVelocity = NiPointToHkVector(HkVectorToNiPoint(body->hkBody->getLinearVelocity()) + deltaVelocity);
@@ -498,11 +599,9 @@ void SimulatePlayerSpace(bhkWorld *world)
             g_prevVelocityAdded = true;
         }
 
-        g_prevPlayerSpaceBodies.clear();
-        g_prevPlayerSpaceBodies.insert(g_playerSpaceBodies.begin(), g_playerSpaceBodies.end());
-
-        g_playerSpaceBodies.clear();
-        g_playerSpaceBodiesShouldNotWarp.clear();
+        std::swap(g_prevPlayerSpaceBodies, g_playerSpaceBodies);
+        g_prevPlayerSpaceBodies->ReleaseReferences();
+        g_playerSpaceBodies->Clear();
 
         g_prevDoWarp = doWarp;
     }
@@ -519,6 +618,9 @@ void SimulatePlayerSpace(bhkWorld *world)
 
 void Update()
 {
+    Profiler::CollectFrame();
+    HIGGS_PROFILE_ZONE("Update");
+
     if (!initComplete) return;
 
     PlayerCharacter *player = *g_thePlayer;
@@ -531,7 +633,7 @@ void Update()
 
     NiPointer<bhkWorld> world = GetHavokWorldFromCell(cell);
     if (!world) {
-        _MESSAGE("Could not get havok world from player cell");
+        AsyncLog::Message("Could not get havok world from player cell");
         return;
     }
 
@@ -547,7 +649,7 @@ void Update()
     if (NiPointer<bhkCharProxyController> controller = GetCharProxyController(*g_thePlayer)) {
         if (controller != g_characterProxyListener.playerProxy) {
             if (RE::hkRefPtr<hkpCharacterProxy> proxy = controller->proxy.characterProxy) {
-                _MESSAGE("%d: Player Character Proxy changed", *g_currentFrameCounter);
+                AsyncLog::Message("%d: Player Character Proxy changed", *g_currentFrameCounter);
 
                 BSWriteLocker lock(&world->worldLock);
 
@@ -562,7 +664,7 @@ void Update()
     if (world != g_physicsListener.world) {
         if (NiPointer<bhkWorld> oldWorld = g_physicsListener.world) {
             // If exists, remove the listener from the previous world
-            _MESSAGE("Removing listeners and collision from old havok world");
+            AsyncLog::Message("Removing listeners and collision from old havok world");
 
             {
                 BSWriteLocker lock(&oldWorld->worldLock);
@@ -584,7 +686,7 @@ void Update()
             }
         }
 
-        _MESSAGE("Adding listeners and collision to new havok world");
+        AsyncLog::Message("Adding listeners and collision to new havok world");
 
         {
             BSWriteLocker lock(&world->worldLock);
@@ -644,14 +746,24 @@ void Update()
     firstHandToUpdate->PreUpdate(*lastHandToUpdate, world);
     lastHandToUpdate->PreUpdate(*firstHandToUpdate, world);
 
+    RunSelectionQueries(world, *g_rightHand, *g_leftHand);
+
     firstHandToUpdate->Update(*lastHandToUpdate, world);
     lastHandToUpdate->Update(*firstHandToUpdate, world);
 
+    FlushKeyframedNodes();
+
     firstHandToUpdate->PostUpdate(*lastHandToUpdate, world);
     lastHandToUpdate->PostUpdate(*firstHandToUpdate, world);
 
+    HiggsPluginAPI::PublishStateSnapshot();
+
     ClearStaleDampedBodies(world);
 
+    if (Config::options.enableShadowUpdateFix) {
+        ShadowUpdateFix_ProcessDeactivatedIslands();
+    }
+
     g_totalMassThisFrame = g_totalMassThisFrameAccumulator; // commit the total mass for this frame
 
     if (Config::options.slowMovementWhenObjectIsHeld) {
@@ -756,13 +868,14 @@ void ShowErrorBox(const char *errorString)
 
 void ShowErrorBoxAndLog(const char *errorString)
 {
-    _ERROR(errorString);
+    AsyncLog::Error(errorString);
     ShowErrorBox(errorString);
 }
 
 void ShowErrorBoxAndTerminate(const char *errorString)
 {
     ShowErrorBoxAndLog(errorString);
+    AsyncLog::Flush(); // so that whatever led up to this makes it into the log
     *((int *)0) = 0xDEADBEEF; // crash
 }
 
@@ -798,6 +911,7 @@ std::mutex g_ignoredCollisionBodiesLock{};
 
 void LateMainThreadUpdate()
 {
+    HIGGS_PROFILE_ZONE("LateMainThreadUpdate");
     //_MESSAGE("%d LateMainThreadUpdate", *g_currentFrameCounter);
 
     g_rightHand->LateMainThreadUpdate();
@@ -936,6 +1050,7 @@ extern "C" {
         
         MenuManager * menuManager = MenuManager::GetSingleton();
         if (menuManager) {
+            MenuChecker::Init();
             menuManager->MenuOpenCloseEventDispatcher()->AddEventSink(&MenuChecker::menuEvent);
         }
 
@@ -952,6 +1067,8 @@ extern "C" {
 
         // Need to heap-allocate and "leak" anything with NiPointers since if they're statically allocated we crash when the game exits and these objects destruct
 
+        ComputeFingerPoseTables();
+
         // Init both hands
         NiPoint3 rightPalm = Config::options.palmPosition;
         NiPoint3 leftPalm = rightPalm;
@@ -1037,27 +1154,27 @@ extern "C" {
         g_leftHand->rolloverScale = Config::options.rolloverScale;
 
         g_controllerType = (*g_openVR)->GetControllerType();
-        _MESSAGE("Controller type detected as %d", g_controllerType);
+        AsyncLog::Message("Controller type detected as %d", g_controllerType);
 
         InputManager *inputManager = InputManager::GetSingleton();
         InputStringHolder *inputStringHolder = InputStringHolder::GetSingleton();
         if (inputManager && inputStringHolder) {
             UInt32 activateKey = inputManager->GetMappedKey(inputStringHolder->activate, kDeviceType_OculusPrimary, InputManager::kContext_Gameplay);
-            _MESSAGE("Activate key detected as %d", activateKey);
+            AsyncLog::Message("Activate key detected as %d", activateKey);
             if (activateKey == vr_src::EVRButtonId::k_EButton_Grip) {
-                _MESSAGE("Activate key is assigned to grip. The activate icon will be replaced with a grip icon");
+                AsyncLog::Message("Activate key is assigned to grip. The activate icon will be replaced with a grip icon");
                 g_isActivateBoundToGrip = true;
             }
         }
 
         if (Config::options.disableRolloverRumble) {
-            _MESSAGE("Disabling rollover rumble");
+            AsyncLog::Message("Disabling rollover rumble");
             Setting	* setting = GetINISetting("fActivateRumbleIntensity:VRInput");
             setting->SetDouble(0);
         }
 
         if (Config::options.alwaysShowHands) {
-            _MESSAGE("Setting bAlwaysShowHands to true");
+            AsyncLog::Message("Setting bAlwaysShowHands to true");
             Setting	*setting = GetINISetting("bAlwaysShowHands:VR");
             setting->SetDouble(1);
         }
@@ -1075,7 +1192,7 @@ extern "C" {
         }
 
         initComplete = true;
-        _MESSAGE("Successfully loaded all forms");
+        AsyncLog::Message("Successfully loaded all forms");
     }
 
     void OnInputLoaded()
@@ -1101,7 +1218,7 @@ extern "C" {
                 // Get the VRIK plugin API
                 g_vrikInterface = vrikPluginApi::getVrikInterface001(g_pluginHandle, g_messaging);
                 if (g_vrikInterface) {
-                    _MESSAGE("Successfully got VRIK api");
+                    AsyncLog::Message("Successfully got VRIK api");
 
                     unsigned int vrikVersion = g_vrikInterface->getBuildNumber();
                     if (vrikVersion < 80400) {
@@ -1109,7 +1226,7 @@ extern "C" {
                     }
                 }
                 else {
-                    _MESSAGE("Did not get VRIK api. This is okay.");
+                    AsyncLog::Message("Did not get VRIK api. This is okay.");
                 }
             }
         }
@@ -1121,7 +1238,7 @@ extern "C" {
         gLog.SetPrintLevel(IDebugLog::kLevel_Message);
         gLog.SetLogLevel(IDebugLog::kLevel_Message);
 
-        _MESSAGE("HIGGS VR v%s", FPVR_VERSION_VERSTRING);
+        AsyncLog::Message("HIGGS VR v%s", FPVR_VERSION_VERSTRING);
 
         info->infoVersion = PluginInfo::kInfoVersion;
         info->name = "HIGGS";
@@ -1130,11 +1247,11 @@ extern "C" {
         g_pluginHandle = skse->GetPluginHandle();
 
         if (skse->isEditor) {
-            _FATALERROR("[FATAL ERROR] Loaded in editor, marking as incompatible!\n");
+            AsyncLog::FatalError("[FATAL ERROR] Loaded in editor, marking as incompatible!\n");
             return false;
         }
         else if (skse->runtimeVersion != RUNTIME_VR_VERSION_1_4_15) {
-            _FATALERROR("[FATAL ERROR] Unsupported runtime version %08X!\n", skse->runtimeVersion);
+            AsyncLog::FatalError("[FATAL ERROR] Unsupported runtime version %08X!\n", skse->runtimeVersion);
             return false;
         }
 
@@ -1143,19 +1260,20 @@ extern "C" {
 
     bool SKSEPlugin_Load(const SKSEInterface * skse)
     {	// Called by SKSE to load this plugin
-        _MESSAGE("HIGGS loaded");
+        AsyncLog::Message("HIGGS loaded");
 
         if (Config::ReadConfigOptions()) {
-            _MESSAGE("Successfully read config parameters");
+            AsyncLog::Message("Successfully read config parameters");
         }
         else {
-            _WARNING("[WARNING] Failed to read config options. Using defaults instead.");
+            AsyncLog::Warning("[WARNING] Failed to read config options. Using defaults instead.");
         }
 
         gLog.SetPrintLevel((IDebugLog::LogLevel)Config::options.logLevel);
         gLog.SetLogLevel((IDebugLog::LogLevel)Config::options.logLevel);
+        AsyncLog::Start();
 
-        _MESSAGE("Registering for SKSE messages");
+        AsyncLog::Message("Registering for SKSE messages");
         g_messaging = (SKSEMessagingInterface*)skse->QueryInterface(kInterface_Messaging);
         g_messaging->RegisterListener(g_pluginHandle, "SKSE", OnSKSEMessage);
 
@@ -1173,7 +1291,7 @@ extern "C" {
             return false;
         }
         if (g_papyrus->Register(PapyrusAPI::RegisterPapyrusFuncs)) {
-            _MESSAGE("Successfully registered papyrus functions");
+            AsyncLog::Message("Successfully registered papyrus functions");
         }
 
         g_taskInterface = (SKSETaskInterface *)skse->QueryInterface(kInterface_Task);
@@ -1184,7 +1302,7 @@ extern "C" {
 
         g_trampoline = (SKSETrampolineInterface *)skse->QueryInterface(kInterface_Trampoline);
         if (!g_trampoline) {
-            _WARNING("Couldn't get trampoline interface");
+            AsyncLog::Warning("Couldn't get trampoline interface");
         }
         if (!TryHook()) {
             ShowErrorBoxAndLog("[CRITICAL] Failed to perform hooks");
@@ -2,6 +2,7 @@
 #include "utils.h"
 #include "config.h"
 #include "finger_curves.h"
+#include "async_log.h"
 
 #include "skse64/NiGeometry.h"
 #include "skse64/GameRTTI.h"
@@ -534,6 +535,36 @@ std::optional<NiTransform> AdvanceTransform(const NiTransform &currentTransform,
     return std::nullopt;
 }
 
+bool AdvancePose(NiPoint3 &pos, NiQuaternion &rot, const NiPoint3 &targetPos, const NiQuaternion &targetRot, float posSpeed, float rotSpeed)
+{
+    // Same as AdvanceTransform, but stays in quaternion form. Returns true if the pose has not reached the target yet.
+    float deltaAngle = rotSpeed * 0.0174533f * *g_deltaTime;
+    float quatAngle = QuaternionAngle(rot, targetRot);
+
+    NiPoint3 deltaDir = VectorNormalized(targetPos - pos);
+    NiPoint3 deltaPos = deltaDir * posSpeed * *g_deltaTime;
+
+    bool doRotation = deltaAngle < quatAngle;
+    bool doTranslation = VectorLengthSquared(deltaPos) < VectorLengthSquared(targetPos - pos);
+
+    if (doRotation) {
+        double slerpAmount = deltaAngle / quatAngle;
+        rot = QuaternionNormalized(slerp(rot, targetRot, slerpAmount));
+    }
+    else {
+        rot = targetRot;
+    }
+
+    if (doTranslation) {
+        pos += deltaPos;
+    }
+    else {
+        pos = targetPos;
+    }
+
+    return doRotation || doTranslation;
+}
+
 std::optional<NiTransform> AdvanceTransformSpeedMultiplied(const NiTransform &currentTransform, const NiTransform &targetTransform, float posSpeedMult, float rotSpeedMult)
 {
     NiQuaternion currentQuat = MatrixToQuaternion(currentTransform.rot);
@@ -1371,13 +1402,13 @@ namespace MathUtils
                                 return false;
                             }
 
-                            _DMESSAGE("pt: %.2f", angle);
+                            HIGGS_DMESSAGE(Fingers, "pt: %.2f", angle);
                             outAngle = angle;
                             return true;
                         }
                         else if (DotProduct(triNormal, largerAngleTangent) <= 0) {
                             float angle = -largerAngle;
-                            _DMESSAGE("pt: %.2f", angle);
+                            HIGGS_DMESSAGE(Fingers, "pt: %.2f", angle);
                             outAngle = angle;
                             return true;
                         }
@@ -1399,7 +1430,7 @@ namespace MathUtils
                                 return false;
                             }
 
-                            _DMESSAGE("pt: %.2f", angle);
+                            HIGGS_DMESSAGE(Fingers, "pt: %.2f", angle);
                             outAngle = angle; // Something negative
                             return true;
                         }
@@ -1473,7 +1504,7 @@ namespace MathUtils
                         if (DotProduct(triNormal, tangent) <= 0) {
                             // Front face of the triangle was intersected CCW around the circle
                             // TODO: Use precise intersection point instead of the current angle / length
-                            _DMESSAGE("pt: %.2f", angle);
+                            HIGGS_DMESSAGE(Fingers, "pt: %.2f", angle);
                             outAngle = angle;
                             return true;
                         }
@@ -1498,7 +1529,7 @@ namespace MathUtils
         bool innerIntersects = CurveCheck(g_fingerInnerVals[fingerIndex], startAngle, endAngle, innerAngle);
 
         if (tipIntersects || outerIntersects || innerIntersects) {
-            _DMESSAGE("inner outer tip: %d %d %d", innerIntersects, outerIntersects, tipIntersects);
+            HIGGS_DMESSAGE(Fingers, "inner outer tip: %d %d %d", innerIntersects, outerIntersects, tipIntersects);
         }
 
         outTipAngle = tipAngle;
@@ -1599,7 +1630,7 @@ bool ShouldIgnoreBasedOnVertexAlpha(BSTriShape *geom)
             totalAlpha += alpha;
         }
         float avgAlpha = totalAlpha / numVerts;
-        _MESSAGE("%s: %.3f avg alpha", geom->m_name, avgAlpha);
+        HIGGS_MESSAGE(Geometry, "%s: %.3f avg alpha", geom->m_name, avgAlpha);
         if (avgAlpha < Config::options.geometryVertexAlphaThreshold) {
             return true;
         }
@@ -1654,7 +1685,7 @@ void UpdateSkinnedTriangles(BSTriShape *geom, std::vector<TriangleData> &triangl
 
     bool hasPartitions = skinPartition && skinPartition->m_pkPartitions && skinPartition->m_uiPartitions > 0;
     if (!hasPartitions) {
-        _MESSAGE("Skindata with no partitions");
+        AsyncLog::Message("Skindata with no partitions");
         return;
     }
 
@@ -1782,7 +1813,7 @@ void UpdateSkinnedTriangles(BSTriShape *geom, std::vector<TriangleData> &triangl
                 }
             }
 
-            _MESSAGE("%d skinned tris", numTris);
+            HIGGS_MESSAGE(Geometry, "%d skinned tris", numTris);
         }
     }
 }
@@ -1837,7 +1868,7 @@ void UpdateTriangles(BSTriShape *geom, std::vector<TriangleData> &triangles, std
 
     if (Config::options.disableGrabGeometryWithVertexAlpha && ShouldIgnoreBasedOnVertexAlpha(geom)) return;
 
-    _MESSAGE("%s: %d tris", geom->m_name, numTris);
+    HIGGS_MESSAGE(Geometry, "%s: %d tris", geom->m_name, numTris);
 
     auto tris = (Triangle *)geomData->triangles;
     uintptr_t verts = (uintptr_t)(geomData->vertices);
@@ -1999,7 +2030,7 @@ bool GetIntersections(const std::vector<TriangleData> &triangles, int fingerInde
         float angle = intersection.angle;
         float degrees = angle * 57.2958f;
 
-        _DMESSAGE("angle: %.2f", degrees);
+        HIGGS_DMESSAGE(Fingers, "angle: %.2f", degrees);
 
         if (angle >= 0 && angle < smallestIntersection.angle) {
             smallestIntersection = { angle, intersection.triangleIndex };
@@ -2095,7 +2126,7 @@ bool GetClosestPointOnGraphicsGeometry(NiAVObject *root, const NiPoint3 &point,
             return false;
         }
 
-        _MESSAGE("%d tris", numTris);
+        HIGGS_MESSAGE(Geometry, "%d tris", numTris);
 
         auto tris = (Triangle *)geomData->triangles;
         uintptr_t verts = (uintptr_t)(geomData->vertices);
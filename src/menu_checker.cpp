@@ -1,118 +1,60 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "menu_checker.h"
 
 // Big thanks to Shizof for this method of checking what menus are open
 namespace MenuChecker
 {
-    std::vector<std::string> iniChangeMenus{
-        "Console",
-        "Journal Menu"
-    };
-    
-    std::vector<std::string> gameStoppingMenus{
-        "BarterMenu",
-        "Book Menu",
-        "Console",
-        "Native UI Menu",
-        "ContainerMenu",
-        "Dialogue Menu",
-        "Crafting Menu",
-        "Credits Menu",
-        "Debug Text Menu",
-        "FavoritesMenu",
-        "GiftMenu",
-        "InventoryMenu",
-        "Journal Menu",
-        "Kinect Menu",
-        "Loading Menu",
-        "Lockpicking Menu",
-        "MagicMenu",
-        "Main Menu",
-        "MapMarkerText3D",
-        "MapMenu",
-        "MessageBoxMenu",
-        "Mist Menu",
-        "Quantity Menu",
-        "RaceSex Menu",
-        "Sleep/Wait Menu",
-        "StatsMenuSkillRing",
-        "StatsMenuPerks",
-        "Training Menu",
-        "Tutorial Menu",
-        "TweenMenu"
-    };
+    std::atomic<UInt64> openMenus = 0;
+    std::atomic<int> numOpenMenus = 0;
+
+    // Interned menu names, sorted by pointer. BSFixedStrings with the same contents share the same data, so the event's menu name can be matched by pointer alone.
+    std::pair<const char *, int> menuIDsByName[numMenus]{};
+    std::vector<BSFixedString> internedMenuNames{}; // holds a reference to each name, so that the pointers above stay valid
+    bool isInitialized = false;
+
+    void Init()
+    {
+        if (isInitialized) return;
+
+        internedMenuNames.reserve(numMenus);
+        for (int i = 0; i < numMenus; i++) {
+            const BSFixedString &name = internedMenuNames.emplace_back(menus[i].name);
+            menuIDsByName[i] = { name.data, i };
+        }
+        std::sort(std::begin(menuIDsByName), std::end(menuIDsByName));
+
+        isInitialized = true;
+    }
 
-    std::unordered_map<std::string, bool> menuTypes({
-        { "BarterMenu", false },
-        { "Book Menu", false },
-        { "Console", false },
-        { "Native UI Menu", false },
-        { "ContainerMenu", false },
-        { "Dialogue Menu", false },
-        { "Crafting Menu", false },
-        { "Credits Menu", false },
-        { "Cursor Menu", false },
-        { "Debug Text Menu", false },
-        { "Fader Menu", false },
-        { "FavoritesMenu", false },
-        { "GiftMenu", false },
-        { "HUD Menu", false },
-        { "InventoryMenu", false },
-        { "Journal Menu", false },
-        { "Kinect Menu", false },
-        { "Loading Menu", false },
-        { "Lockpicking Menu", false },
-        { "MagicMenu", false },
-        { "Main Menu", false },
-        { "MapMarkerText3D", false },
-        { "MapMenu", false },
-        { "MessageBoxMenu", false },
-        { "Mist Menu", false },
-        { "Overlay Interaction Menu", false },
-        { "Overlay Menu", false },
-        { "Quantity Menu", false },
-        { "RaceSex Menu", false },
-        { "Sleep/Wait Menu", false },
-        { "StatsMenu", false },
-        { "StatsMenuPerks", false },
-        { "StatsMenuSkillRing", false },
-        { "TitleSequence Menu", false },
-        { "Top Menu", false },
-        { "Training Menu", false },
-        { "Tutorial Menu", false },
-        { "TweenMenu", false },
-        { "WSEnemyMeters", false },
-        { "WSDebugOverlay", false },
-        { "WSActivateRollover", false },
-        { "LoadWaitSpinner", false }
-    });
+    int GetMenuID(const BSFixedString &menuName)
+    {
+        auto it = std::lower_bound(std::begin(menuIDsByName), std::end(menuIDsByName), std::make_pair(menuName.data, -1));
+        if (it == std::end(menuIDsByName) || it->first != menuName.data) return -1;
+        return it->second;
+    }
 
     // Menu open event functions
     AllMenuEventHandler menuEvent;
     
     EventResult AllMenuEventHandler::ReceiveEvent(MenuOpenCloseEvent * evn, EventDispatcher<MenuOpenCloseEvent> * dispatcher)
     {
-        const char * menuName = evn->menuName.data;
-                
+        int menuID = GetMenuID(evn->menuName);
+        if (menuID < 0) return EventResult::kEvent_Continue;
+
+        UInt64 bit = 1ULL << menuID;
         if (evn->opening) { // Menu opened
-            if (menuTypes.find(menuName) != menuTypes.end()) {
-                menuTypes[menuName] = true;
+            if (!(openMenus.fetch_or(bit, std::memory_order_release) & bit)) {
+                ++numOpenMenus;
             }
         }
         else { // Menu closed
-            if (menuTypes.find(menuName) != menuTypes.end()) {
-                menuTypes[menuName] = false;
-            }			
-        }
-        return EventResult::kEvent_Continue;
-    }
-
-    bool isGameStopped()
-    {
-        for (int i = 0; i < gameStoppingMenus.size(); i++) {
-            if (menuTypes[gameStoppingMenus[i]] == true) {
-                return true;
+            if (openMenus.fetch_and(~bit, std::memory_order_release) & bit) {
+                --numOpenMenus;
             }
         }
-        return false;
+        return EventResult::kEvent_Continue;
     }
 }
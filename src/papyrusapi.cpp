@@ -1,6 +1,7 @@
 #include "papyrusapi.h"
 #include "pluginapi.h"
 #include "hand.h"
+#include "async_log.h"
 
 namespace PapyrusAPI
 {
@@ -14,6 +15,68 @@ namespace PapyrusAPI
         return g_interface001.SetSettingDouble(name.c_str(), val);
     }
 
+    // Same as GetSetting for each name, in one call
+    VMResultArray<float> PapyrusGetSettings(StaticFunctionTag *base, VMArray<BSFixedString> names) {
+        VMResultArray<float> values;
+        values.reserve(names.Length());
+        for (UInt32 i = 0; i < names.Length(); i++) {
+            BSFixedString name;
+            names.Get(&name, i);
+            values.push_back(PapyrusGetSetting(base, name));
+        }
+        return values;
+    }
+
+    // Same as SetSetting for each name / value pair, in one call. Returns how many were set.
+    SInt32 PapyrusSetSettings(StaticFunctionTag *base, VMArray<BSFixedString> names, VMArray<float> values) {
+        if (names.Length() != values.Length()) {
+            AsyncLog::Warning("[WARNING] SetSettings called with %d names but %d values", names.Length(), values.Length());
+        }
+
+        SInt32 numSet = 0;
+        UInt32 count = min(names.Length(), values.Length());
+        for (UInt32 i = 0; i < count; i++) {
+            BSFixedString name;
+            float val;
+            names.Get(&name, i);
+            values.Get(&val, i);
+            if (g_interface001.SetSettingDouble(name.c_str(), val)) {
+                ++numSet;
+            }
+        }
+        return numSet;
+    }
+
+    // Everything about the hand that would otherwise take a call each, laid out as in HandStateField
+    VMResultArray<float> PapyrusGetHandState(StaticFunctionTag *base, bool isLeft) {
+        VMResultArray<float> fields(kHandState_Count, 0.f);
+
+        HiggsPluginAPI::IHiggsInterface002::StateSnapshot snapshot;
+        if (!g_interface001.GetStateSnapshot(snapshot)) return fields;
+
+        const HiggsPluginAPI::IHiggsInterface002::HandSnapshot &hand = snapshot.hands[isLeft];
+        fields[kHandState_State] = float(hand.state);
+        fields[kHandState_IsHoldingObject] = hand.isHoldingObject;
+        fields[kHandState_CanGrabObject] = hand.canGrabObject;
+        fields[kHandState_IsInGrabbableState] = hand.isInGrabbableState;
+        fields[kHandState_IsDisabled] = hand.isDisabled;
+        fields[kHandState_IsWeaponCollisionDisabled] = hand.isWeaponCollisionDisabled;
+        fields[kHandState_IsTwoHanding] = snapshot.isTwoHanding;
+        fields[kHandState_IsHeldObjectColliding] = hand.isHeldObjectColliding;
+        for (int i = 0; i < 5; i++) {
+            fields[kHandState_FingerValues + i] = hand.fingerValues[i];
+        }
+        return fields;
+    }
+
+    // The objects held in the right and left hand, in that order. None for a hand that isn't holding anything.
+    VMResultArray<TESObjectREFR *> PapyrusGetGrabbedObjects(StaticFunctionTag *base) {
+        VMResultArray<TESObjectREFR *> objects;
+        objects.push_back(g_interface001.GetGrabbedObject(false));
+        objects.push_back(g_interface001.GetGrabbedObject(true));
+        return objects;
+    }
+
     void PapyrusGrabObject(StaticFunctionTag *base, TESObjectREFR *object, bool isLeft) {
         g_interface001.GrabObject(object, isLeft);
     }
@@ -61,160 +124,160 @@ namespace PapyrusAPI
     RegistrationSetHolder<TESForm*> g_pullEventRegs;
     void RegisterForPullEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for pull event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for pull event with null parameter");
             return;
         }
         g_pullEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for pull event", object->formID);
+            AsyncLog::Message("%d registered for pull event", object->formID);
     }
     void UnregisterForPullEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for pull event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for pull event with null parameter");
             return;
         }
         g_pullEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for pull event", object->formID);
+            AsyncLog::Message("%d unregistered for pull event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_grabEventRegs;
     void RegisterForGrabEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for grab event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for grab event with null parameter");
             return;
         }
         g_grabEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for grab event", object->formID);
+            AsyncLog::Message("%d registered for grab event", object->formID);
     }
     void UnregisterForGrabEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for grab event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for grab event with null parameter");
             return;
         }
         g_grabEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for grab event", object->formID);
+            AsyncLog::Message("%d unregistered for grab event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_dropEventRegs;
     void RegisterForDropEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for drop event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for drop event with null parameter");
             return;
         }
         g_dropEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for drop event", object->formID);
+            AsyncLog::Message("%d registered for drop event", object->formID);
     }
     void UnregisterForDropEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for drop event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for drop event with null parameter");
             return;
         }
         g_dropEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for drop event", object->formID);
+            AsyncLog::Message("%d unregistered for drop event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_stashEventRegs;
     void RegisterForStashEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for stash event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for stash event with null parameter");
             return;
         }
         g_stashEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for stash event", object->formID);
+            AsyncLog::Message("%d registered for stash event", object->formID);
     }
     void UnregisterForStashEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for stash event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for stash event with null parameter");
             return;
         }
         g_stashEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for stash event", object->formID);
+            AsyncLog::Message("%d unregistered for stash event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_consumeEventRegs;
     void RegisterForConsumeEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for consume event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for consume event with null parameter");
             return;
         }
         g_consumeEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for consume event", object->formID);
+            AsyncLog::Message("%d registered for consume event", object->formID);
     }
     void UnregisterForConsumeEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for consume event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for consume event with null parameter");
             return;
         }
         g_consumeEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for consume event", object->formID);
+            AsyncLog::Message("%d unregistered for consume event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_startTwoHandingEventRegs;
     void RegisterForStartTwoHandingEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for start two handing event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for start two handing event with null parameter");
             return;
         }
         g_startTwoHandingEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for start two handing event", object->formID);
+            AsyncLog::Message("%d registered for start two handing event", object->formID);
     }
     void UnregisterForStartTwoHandingEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for start two handing event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for start two handing event with null parameter");
             return;
         }
         g_startTwoHandingEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for start two handing event", object->formID);
+            AsyncLog::Message("%d unregistered for start two handing event", object->formID);
     }
 
     RegistrationSetHolder<TESForm*> g_stopTwoHandingEventRegs;
     void RegisterForStopTwoHandingEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to register for stop two handing event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to register for stop two handing event with null parameter");
             return;
         }
         g_stopTwoHandingEventRegs.Register(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d registered for stop two handing event", object->formID);
+            AsyncLog::Message("%d registered for stop two handing event", object->formID);
     }
     void UnregisterForStopTwoHandingEvent(StaticFunctionTag *base, TESForm* object) {
         if (!object) {
-            _WARNING("[WARNING] Attempt to unregister for stop two handing event with null parameter");
+            AsyncLog::Warning("[WARNING] Attempt to unregister for stop two handing event with null parameter");
             return;
         }
         g_stopTwoHandingEventRegs.Unregister(object->GetFormType(), object);
 
         if (object && object->formID)
-            _MESSAGE("%d unregistered for stop two handing event", object->formID);
+            AsyncLog::Message("%d unregistered for stop two handing event", object->formID);
     }
 
     void OnPullEvent(TESObjectREFR *refr, bool isLeft) {
         if (g_pullEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus pull event");
+            AsyncLog::Message("Papyrus pull event");
             static BSFixedString eventName("OnObjectPulled");
             g_pullEventRegs.ForEach(
                 EventFunctor2<TESObjectREFR *, bool>(eventName, refr, isLeft)
@@ -224,7 +287,7 @@ namespace PapyrusAPI
 
     void OnGrabEvent(TESObjectREFR *refr, bool isLeft) {
         if (g_grabEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus grab event");
+            AsyncLog::Message("Papyrus grab event");
             static BSFixedString eventName("OnObjectGrabbed");
             g_grabEventRegs.ForEach(
                 EventFunctor2<TESObjectREFR *, bool>(eventName, refr, isLeft)
@@ -234,7 +297,7 @@ namespace PapyrusAPI
 
     void OnDropEvent(TESObjectREFR *refr, bool isLeft) {
         if (g_dropEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus drop event");
+            AsyncLog::Message("Papyrus drop event");
             static BSFixedString eventName("OnObjectDropped");
             g_dropEventRegs.ForEach(
                 EventFunctor2<TESObjectREFR *, bool>(eventName, refr, isLeft)
@@ -244,7 +307,7 @@ namespace PapyrusAPI
 
     void OnStashEvent(TESForm *form, bool isLeft) {
         if (g_stashEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus stash event");
+            AsyncLog::Message("Papyrus stash event");
             static BSFixedString eventName("OnObjectStashed");
             g_stashEventRegs.ForEach(
                 EventFunctor2<TESForm *, bool>(eventName, form, isLeft)
@@ -254,7 +317,7 @@ namespace PapyrusAPI
 
     void OnConsumeEvent(TESForm *form, bool isLeft) {
         if (g_consumeEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus consume event");
+            AsyncLog::Message("Papyrus consume event");
             static BSFixedString eventName("OnObjectConsumed");
             g_consumeEventRegs.ForEach(
                 EventFunctor2<TESForm *, bool>(eventName, form, isLeft)
@@ -264,7 +327,7 @@ namespace PapyrusAPI
 
     void OnStartTwoHandingEvent() {
         if (g_startTwoHandingEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus start two handing event");
+            AsyncLog::Message("Papyrus start two handing event");
             static BSFixedString eventName("OnStartTwoHanding");
             g_startTwoHandingEventRegs.ForEach(
                 EventFunctor0(eventName)
@@ -274,7 +337,7 @@ namespace PapyrusAPI
 
     void OnStopTwoHandingEvent() {
         if (g_stopTwoHandingEventRegs.m_data.size() > 0) {
-            _MESSAGE("Papyrus stop two handing event");
+            AsyncLog::Message("Papyrus stop two handing event");
             static BSFixedString eventName("OnStopTwoHanding");
             g_stopTwoHandingEventRegs.ForEach(
                 EventFunctor0(eventName)
@@ -285,6 +348,8 @@ namespace PapyrusAPI
     bool RegisterPapyrusFuncs(VMClassRegistry* registry) {
         registry->RegisterFunction(new NativeFunction1<StaticFunctionTag, float, BSFixedString>("GetSetting", "HiggsVR", PapyrusGetSetting, registry));
         registry->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, float>("SetSetting", "HiggsVR", PapyrusSetSetting, registry));
+        registry->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMResultArray<float>, VMArray<BSFixedString>>("GetSettings", "HiggsVR", PapyrusGetSettings, registry));
+        registry->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, VMArray<BSFixedString>, VMArray<float>>("SetSettings", "HiggsVR", PapyrusSetSettings, registry));
 
         registry->RegisterFunction(new NativeFunction2 <StaticFunctionTag, void, TESObjectREFR*, bool>("GrabObject", "HiggsVR", PapyrusGrabObject, registry));
         registry->RegisterFunction(new NativeFunction1 <StaticFunctionTag, TESObjectREFR*, bool>("GetGrabbedObject", "HiggsVR", PapyrusGetGrabbedObject, registry));
@@ -301,6 +366,13 @@ namespace PapyrusAPI
 
         registry->RegisterFunction(new NativeFunction0 <StaticFunctionTag, bool>("IsTwoHanding", "HiggsVR", PapyrusIsTwoHanding, registry));
 
+        registry->RegisterFunction(new NativeFunction1 <StaticFunctionTag, VMResultArray<float>, bool>("GetHandState", "HiggsVR", PapyrusGetHandState, registry));
+        registry->RegisterFunction(new NativeFunction0 <StaticFunctionTag, VMResultArray<TESObjectREFR *>>("GetGrabbedObjects", "HiggsVR", PapyrusGetGrabbedObjects, registry));
+
+        // These only read from the per-frame snapshot / settings, so there's no need to wait for the next frame to run them
+        registry->SetFunctionFlags("HiggsVR", "GetSettings", VMClassRegistry::kFunctionFlag_NoWait);
+        registry->SetFunctionFlags("HiggsVR", "GetHandState", VMClassRegistry::kFunctionFlag_NoWait);
+
         registry->RegisterFunction(new NativeFunction1 <StaticFunctionTag, void, TESForm*>("RegisterForPullEvent", "HiggsVR", RegisterForPullEvent, registry));
         registry->RegisterFunction(new NativeFunction1 <StaticFunctionTag, void, TESForm*>("UnregisterForPullEvent", "HiggsVR", UnregisterForPullEvent, registry));
 
@@ -1,3 +1,4 @@
+#include <mutex>
 #include <sstream>
 
 #include "RE/offsets.h"
@@ -11,6 +12,7 @@
 #include "skse64/NiNodes.h"
 #include "skse64/gamethreads.h"
 #include "skse64/GameRTTI.h"
+#include "async_log.h"
 
 #include <Physics/Collide/Query/CastUtil/hkpLinearCastInput.h>
 #include <Physics/Collide/Dispatch/hkpCollisionDispatcher.h>
@@ -306,53 +308,66 @@ struct CreateDetectionEventTask : TaskDelegate
 };
 
 
-void ShadowUpdateFix_IslandDeactivatedCallback(hkpSimulationIsland *island)
+std::mutex g_deactivatedIslandsLock;
+std::vector<hkAabb> g_deactivatedIslandBounds{}; // one per island that deactivated since the last check, around its moveable bodies
+
+static void ShadowUpdateFix_InitIslandBounds(hkAabb &bounds)
 {
-    int numEntities = island->m_entities.getSize();
-    if (numEntities <= 0) return;
+    bounds.m_min.setAll(HK_REAL_MAX);
+    bounds.m_max.setAll(-HK_REAL_MAX);
+}
 
-    if (g_numShadowUpdates > 0) {
-        return; // We're already doing an update this frame
+static void ShadowUpdateFix_AddToIslandBounds(hkpEntity *entity, hkAabb &bounds)
+{
+    if (!IsMoveableEntity(entity) ||
+        (entity->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo & 0x7f) == 0x21 || // 0x21 == L_BIPED_NO_CC
+        (entity->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo & 0x7f) == 0x20 // 0x20 == L_DEADBIP
+        ) {
+        return;
     }
 
-    auto SetShadowsToUpdateThisFrame = []() {
-        //_MESSAGE("Island deactived on frame %d", *g_currentFrameCounter);
-        g_numShadowUpdates = Config::options.numShadowUpdates;
-    };
+    const hkVector4 &position = entity->getPosition();
+    bounds.m_min.setMin4(bounds.m_min, position);
+    bounds.m_max.setMax4(bounds.m_max, position);
+}
 
-    if (numEntities > Config::options.maxNumEntitiesPerSimulationIslandToCheck) {
-        SetShadowsToUpdateThisFrame();
-        return;
+static void ShadowUpdateFix_IslandDeactivated(const hkAabb &bounds)
+{
+    if (bounds.m_min(0) > bounds.m_max(0)) return; // no moveable bodies
+
+    // Havok calls this during the step, and the island may be merged or freed by the time the main thread gets to it, so only its bounds are kept
+    std::scoped_lock lock(g_deactivatedIslandsLock);
+    g_deactivatedIslandBounds.push_back(bounds);
+}
+
+void ShadowUpdateFix_ProcessDeactivatedIslands()
+{
+    static std::vector<hkAabb> islandBounds{};
+    {
+        std::scoped_lock lock(g_deactivatedIslandsLock);
+        islandBounds.swap(g_deactivatedIslandBounds);
     }
+    DeferVectorClear clearIslandBounds(islandBounds);
 
-    bool anyToProcess = false;
-    for (hkpEntity *entity : island->m_entities) {
-        if (IsMoveableEntity(entity) &&
-            ((entity->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo & 0x7f) != 0x21) && // 0x21 == L_BIPED_NO_CC
-            (entity->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo & 0x7f) != 0x20 // 0x20 == L_DEADBIP
-            ) {
-            anyToProcess = true;
-            break;
-        }
+    if (islandBounds.empty()) return;
+
+    if (g_numShadowUpdates > 0) {
+        return; // We're already doing an update this frame
     }
 
-    if (anyToProcess) {
-        PlayerCharacter *player = *g_thePlayer;
-        float havokWorldScale = *g_havokWorldScale;
-        NiPoint3 playerPos = player->pos * havokWorldScale;
+    hkVector4 playerPos = NiPointToHkVector((*g_thePlayer)->pos * *g_havokWorldScale);
+    float radius = Config::options.maxDistanceOfSimulationIslandToUpdate;
 
-        bool isAnyWithinRadius = false;
-        for (hkpEntity *entity : island->m_entities) {
-            NiPoint3 pos = HkVectorToNiPoint(entity->m_motion.getTransform().m_translation);
-            float distFromPlayer = VectorLength(pos - playerPos);
-            if (distFromPlayer < Config::options.maxDistanceOfSimulationIslandToUpdate) {
-                isAnyWithinRadius = true;
-                break;
-            }
-        }
+    for (const hkAabb &bounds : islandBounds) {
+        // Closest point of the bounds to the player
+        hkVector4 closest; closest.setMax4(playerPos, bounds.m_min);
+        closest.setMin4(closest, bounds.m_max);
 
-        if (isAnyWithinRadius) {
-            SetShadowsToUpdateThisFrame();
+        hkVector4 offset; offset.setSub4(closest, playerPos);
+        if (offset.length3() < radius) {
+            //_MESSAGE("Island deactived on frame %d", *g_currentFrameCounter);
+            g_numShadowUpdates = Config::options.numShadowUpdates;
+            return;
         }
     }
 }
@@ -385,13 +400,19 @@ void IslandDeactivationListener::islandActivatedCallback(hkpSimulationIsland* is
 
 void IslandDeactivationListener::islandDeactivatedCallback(hkpSimulationIsland* island)
 {
-    ShadowUpdateFix_IslandDeactivatedCallback(island);
+    bhkWorld *world = ((ahkpWorld *)island->getWorld())->m_userData;
 
-    if (bhkWorld *world = ((ahkpWorld *)island->getWorld())->m_userData) {
-        for (hkpEntity *entity : island->m_entities) {
+    // One pass over the island does both, so that big islands aren't walked twice
+    hkAabb bounds; ShadowUpdateFix_InitIslandBounds(bounds);
+    for (hkpEntity *entity : island->m_entities) {
+        ShadowUpdateFix_AddToIslandBounds(entity, bounds);
+
+        if (world) {
             RemoveHiggsDroppedTrackingInfo(entity);
         }
     }
+
+    ShadowUpdateFix_IslandDeactivated(bounds);
 }
 
 
@@ -639,8 +660,11 @@ void PhysicsListener::RegisterHandCollision(hkpRigidBody *body, float separating
 
 void PhysicsListener::DisableContactsTemporarily(hkpRigidBody *bodyA, hkpRigidBody *bodyB, double duration)
 {
-    ignoreContactPointData[bodyA] = { bodyB, g_currentFrameTime, duration };
-    ignoreContactPointData[bodyB] = { bodyA, g_currentFrameTime, duration };
+    double endTime = g_currentFrameTime + duration;
+    ignoreContactPointData[bodyA] = { bodyB, endTime };
+    ignoreContactPointData[bodyB] = { bodyA, endTime };
+    ignoreContactPointExpiry.Schedule(bodyA, endTime);
+    ignoreContactPointExpiry.Schedule(bodyB, endTime);
 }
 
 void PhysicsListener::HandleIgnoredContact(const hkpContactPointEvent &evnt)
@@ -650,7 +674,7 @@ void PhysicsListener::HandleIgnoredContact(const hkpContactPointEvent &evnt)
     // Only need to check one direction, since we add both directions to the map
     auto it = ignoreContactPointData.find(evnt.m_bodies[0]);
     if (it != ignoreContactPointData.end()) {
-        if (it->second.body == evnt.m_bodies[1] && g_currentFrameTime - it->second.startTime < it->second.ignoreTime) {
+        if (it->second.body == evnt.m_bodies[1] && g_currentFrameTime < it->second.endTime) {
             evnt.m_contactPointProperties->m_flags |= hkContactPointMaterial::FlagEnum::CONTACT_IS_DISABLED;
             return;
         }
@@ -767,15 +791,10 @@ void PhysicsListener::postSimulationCallback(hkpWorld* world)
     g_rightEntityCollisionListener.PostSimulationUpdate();
     g_leftEntityCollisionListener.PostSimulationUpdate();
 
-    // Clear out old ignore contact point data
-    for (auto it = ignoreContactPointData.begin(); it != ignoreContactPointData.end();) {
-        if (g_currentFrameTime - it->second.startTime > it->second.ignoreTime + 1.0) {
-            it = ignoreContactPointData.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
+    // Clear out expired ignore contact point data
+    ignoreContactPointExpiry.PopExpired(g_currentFrameTime, [this](hkpRigidBody *body) {
+        ignoreContactPointData.erase(body);
+    });
 }
 
 
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+
+#include "physics_scheduler.h"
+#include "RE/offsets.h"
+#include "config.h"
+#include "hand.h"
+#include "async_log.h"
+
+#include <Physics/Dynamics/World/hkpSimulationIsland.h>
+#include <Physics/Dynamics/World/hkpWorld.h>
+
+
+namespace PhysicsStepScheduler {
+    constexpr float g_stepCostSmoothing = 0.1f; // weight of the newest measurement in the running average of the step cost
+    constexpr float g_heldObjectLoad = 10.f; // a held object costs about as much as this many constraints, between its own constraint / keyframing and everything it pushes around
+    constexpr float g_loadCostScale = 0.01f; // how much each constraint adds to the cost of a step, relative to a step with nothing going on
+
+    // Only switches to a different step count once it's been the candidate for a few frames in a row, so that noisy step timings don't make it flip back and forth
+    struct StepCountHysteresis
+    {
+        constexpr int Update(int candidate, int hysteresisFrames)
+        {
+            if (!hasValue) {
+                hasValue = true;
+                current = candidate;
+            }
+
+            if (candidate == current) {
+                pending = 0;
+                numFramesPending = 0;
+                return current;
+            }
+
+            if (candidate == pending) {
+                ++numFramesPending;
+            }
+            else {
+                pending = candidate;
+                numFramesPending = 1;
+            }
+
+            if (numFramesPending >= hysteresisFrames) {
+                current = candidate;
+                pending = 0;
+                numFramesPending = 0;
+            }
+            return current;
+        }
+
+        int current = 1;
+        int pending = 0;
+        int numFramesPending = 0;
+        bool hasValue = false;
+    };
+
+    // A steady new candidate is taken up on exactly the Nth frame, and a candidate that doesn't hold for N frames in a row never is
+    static_assert([] {
+        StepCountHysteresis hysteresis;
+        if (hysteresis.Update(2, 3) != 2) return false;
+        if (hysteresis.Update(4, 3) != 2 || hysteresis.Update(4, 3) != 2 || hysteresis.Update(4, 3) != 4) return false;
+        if (hysteresis.Update(1, 3) != 4 || hysteresis.Update(1, 3) != 4 || hysteresis.Update(4, 3) != 4) return false;
+        if (hysteresis.Update(1, 3) != 4 || hysteresis.Update(1, 3) != 4 || hysteresis.Update(1, 3) != 1) return false;
+        return true;
+    }(), "Physics step count hysteresis is broken");
+
+    Decision g_lastDecision{};
+    bool g_hasDecided = false;
+    StepCountHysteresis g_stepCountHysteresis{};
+
+    float g_normalizedStepCostMs = -1.f; // running average of the step cost divided by the load factor it was measured under
+    int g_lastNumActiveConstraints = 0;
+
+
+    int CountHeldObjects()
+    {
+        return int(g_rightHand->HasHeldObject()) + int(g_leftHand->HasHeldObject());
+    }
+
+    float GetLoadFactor(int numActiveConstraints, int numHeldObjects)
+    {
+        return 1.f + g_loadCostScale * (float(numActiveConstraints) + float(numHeldObjects) * g_heldObjectLoad);
+    }
+
+    int CountActiveConstraints(hkpWorld *world)
+    {
+        // Contact manifolds between colliding bodies are constraints too, so this covers both
+        int numConstraints = 0;
+        const hkArray<hkpSimulationIsland *> &islands = world->getActiveSimulationIslands();
+        for (int i = 0; i < islands.getSize(); i++) {
+            numConstraints += islands[i]->m_numConstraints;
+        }
+        return numConstraints;
+    }
+
+    void RecordStep(double stepTimeMs, int numActiveConstraints)
+    {
+        g_lastNumActiveConstraints = numActiveConstraints;
+
+        float normalizedCostMs = float(stepTimeMs) / GetLoadFactor(numActiveConstraints, CountHeldObjects());
+        if (g_normalizedStepCostMs < 0.f) {
+            g_normalizedStepCostMs = normalizedCostMs;
+        }
+        else {
+            g_normalizedStepCostMs += (normalizedCostMs - g_normalizedStepCostMs) * g_stepCostSmoothing;
+        }
+    }
+
+    void ScheduleFrame(float frameTime)
+    {
+        int maxSteps = max(1, (int)*g_uMaxNumPhysicsStepsPerUpdate);
+        int maxStepsComplex = max(1, (int)*g_uMaxNumPhysicsStepsPerUpdateComplex);
+
+        // As many steps as it takes to keep each one under 1 / minPhysicsFrameRate, which is all we'd do without a budget
+        float maxPhysicsFrameTime = 1.f / Config::options.minPhysicsFrameRate;
+        int numStepsWanted = std::clamp(int(ceilf(frameTime / maxPhysicsFrameTime - 0.0001f)), 1, maxSteps);
+
+        int numHeldObjects = CountHeldObjects();
+        float loadFactor = GetLoadFactor(g_lastNumActiveConstraints, numHeldObjects);
+
+        // In deterministic mode, nothing measured goes into the decision, so the same inputs always give the same steps
+        float baseStepCostMs = Config::options.deterministicPhysicsSteps ? Config::options.deterministicPhysicsStepCostMs : g_normalizedStepCostMs;
+        float predictedStepCostMs = baseStepCostMs * loadFactor;
+
+        int numStepsAffordable = maxSteps; // nothing measured yet, so no limit
+        if (predictedStepCostMs > 0.f) {
+            numStepsAffordable = std::clamp(int(Config::options.physicsStepBudgetMs / predictedStepCostMs), 1, maxSteps);
+        }
+
+        // Only the budget's limit is held back, so the steps that minPhysicsFrameRate needs are still taken right away on a frame time spike
+        numStepsAffordable = g_stepCountHysteresis.Update(numStepsAffordable, Config::options.physicsStepHysteresisFrames);
+        int numSteps = min(numStepsWanted, numStepsAffordable);
+
+        Decision decision;
+        decision.numSteps = numSteps;
+        decision.numStepsComplex = min(numSteps, maxStepsComplex);
+        decision.maxStepTime = frameTime / float(decision.numSteps);
+        decision.maxStepTimeComplex = frameTime / float(decision.numStepsComplex) * Config::options.havokMaxTimeComplexMultiplier;
+        decision.predictedStepCostMs = predictedStepCostMs;
+
+        *fMaxTime = decision.maxStepTime;
+        *fMaxTimeComplex = decision.maxStepTimeComplex;
+
+        HIGGS_DMESSAGE(Physics, "Physics steps: %d (%d wanted, %d complex), %.3f ms predicted per step, %d constraints, %d held",
+            decision.numSteps, numStepsWanted, decision.numStepsComplex, predictedStepCostMs, g_lastNumActiveConstraints, numHeldObjects);
+
+        if (g_hasDecided && decision.numSteps != g_lastDecision.numSteps) {
+            HIGGS_VMESSAGE(Physics, "Switched from %d to %d physics steps per frame", g_lastDecision.numSteps, decision.numSteps);
+        }
+
+        g_lastDecision = decision;
+        g_hasDecided = true;
+    }
+
+    const Decision & GetLastDecision()
+    {
+        return g_lastDecision;
+    }
+}
@@ -5,6 +5,9 @@
 #include "papyrusapi.h"
 #include "config.h"
 #include "hand.h"
+#include "profiler.h"
+#include "physics.h"
+#include "async_log.h"
 
 using namespace HiggsPluginAPI;
 
@@ -20,7 +23,8 @@ HiggsInterface001 g_interface001;
 // Constructs and returns an API of the revision number requested
 void * GetApi(unsigned int revisionNumber) {
     switch (revisionNumber) {
-    case 1:	_MESSAGE("Interface revision 1 requested"); return &g_interface001;
+    case 1:	AsyncLog::Message("Interface revision 1 requested"); return static_cast<IHiggsInterface001 *>(&g_interface001);
+    case 2:	AsyncLog::Message("Interface revision 2 requested"); return static_cast<IHiggsInterface002 *>(&g_interface001);
     }
     return nullptr;
 }
@@ -30,7 +34,7 @@ void HiggsPluginAPI::ModMessageHandler(SKSEMessagingInterface::Message * message
     if (message->type == HiggsMessage::kMessage_GetInterface) {
         HiggsMessage * higgsMessage = (HiggsMessage*)message->data;
         higgsMessage->getApiFunction = GetApi;
-        _MESSAGE("Provided HIGGS plugin interface to \"%s\"", message->sender);
+        AsyncLog::Message("Provided HIGGS plugin interface to \"%s\"", message->sender);
     }
 }
 
@@ -420,3 +424,77 @@ void HiggsInterface001::GetFingerValues(bool isLeft, float values[5])
         values[i] = hand.grabbedFingerValues[i];
     }
 }
+
+int HiggsInterface001::GetNumProfilerZones()
+{
+    return Profiler::GetNumZones();
+}
+
+bool HiggsInterface001::GetProfilerZoneStats(int zoneIndex, ProfilerZoneStats &statsOut)
+{
+    Profiler::ZoneStats stats;
+    if (!Profiler::GetZoneStats(zoneIndex, stats)) return false;
+
+    statsOut.name = stats.name;
+    statsOut.numSamples = stats.numSamples;
+    statsOut.minMs = stats.minMs;
+    statsOut.avgMs = stats.avgMs;
+    statsOut.p99Ms = stats.p99Ms;
+    statsOut.maxMs = stats.maxMs;
+    return true;
+}
+
+const IHiggsInterface002::StateSnapshotBuffer * HiggsInterface001::GetStateSnapshotBuffer()
+{
+    return &stateSnapshotBuffer;
+}
+
+bool HiggsInterface001::GetStateSnapshot(StateSnapshot &snapshotOut)
+{
+    return ReadStateSnapshot(&stateSnapshotBuffer, snapshotOut);
+}
+
+static_assert(UInt8(Hand::State::HeldTwoHanded) == UInt8(IHiggsInterface002::HandState::HeldTwoHanded), "Public hand states are out of sync with Hand::State");
+
+void FillHandSnapshot(Hand &hand, IHiggsInterface002::HandSnapshot &handSnapshot)
+{
+    handSnapshot.state = IHiggsInterface002::HandState(hand.state);
+    handSnapshot.isHoldingObject = hand.HasHeldObject();
+    handSnapshot.isInGrabbableState = hand.IsInGrabbableState();
+    handSnapshot.isDisabled = g_interface001.IsDisabled(hand.isLeft);
+    handSnapshot.isWeaponCollisionDisabled = g_interface001.IsWeaponCollisionDisabled(hand.isLeft);
+    handSnapshot.isHeldObjectColliding = handSnapshot.isHoldingObject && (hand.isLeft ? g_leftEntityCollisionListener : g_rightEntityCollisionListener).IsColliding();
+    handSnapshot.canGrabObject = hand.CanGrabObject();
+    handSnapshot.pad07 = 0;
+    handSnapshot.selectedHandle = hand.state == Hand::State::Idle ? 0 : hand.selectedObject.handle;
+    handSnapshot.heldHandle = handSnapshot.isHoldingObject ? hand.selectedObject.handle : 0;
+    for (int i = 0; i < 5; i++) {
+        handSnapshot.fingerValues[i] = hand.grabbedFingerValues[i];
+    }
+    handSnapshot.grabTransform = hand.GetGrabTransform();
+    handSnapshot.handLinearVelocity = hand.controllerData.linearVelocities[0];
+    handSnapshot.handAngularVelocity = hand.controllerData.angularVelocities[0];
+}
+
+void HiggsPluginAPI::PublishStateSnapshot()
+{
+    // Fill it out on the side so that readers only ever have to wait on the copy
+    IHiggsInterface002::StateSnapshot snapshot{};
+    snapshot.version = IHiggsInterface002::kStateSnapshotVersion;
+    snapshot.size = sizeof(snapshot);
+    snapshot.isTwoHanding = g_interface001.IsTwoHanding();
+    snapshot.frameTime = g_currentFrameTime;
+    FillHandSnapshot(*g_rightHand, snapshot.hands[0]);
+    FillHandSnapshot(*g_leftHand, snapshot.hands[1]);
+
+    IHiggsInterface002::StateSnapshotBuffer &buffer = g_interface001.stateSnapshotBuffer;
+    snapshot.frameCount = buffer.snapshot.frameCount + 1; // only ever written from here, so no need to synchronize the read
+
+    UInt32 sequence = buffer.sequence.load(std::memory_order_relaxed);
+    buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(&buffer.snapshot, &snapshot, sizeof(snapshot));
+
+    buffer.sequence.store(sequence + 2, std::memory_order_release);
+}
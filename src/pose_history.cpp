@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "pose_history.h"
+#include "math_utils.h"
+
+
+void PoseHistory::Push(const PoseSample &sample)
+{
+    UInt64 index = writeCount.load(std::memory_order_relaxed);
+    Slot &slot = slots[index % capacity];
+
+    UInt32 sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.sample = sample;
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    writeCount.store(index + 1, std::memory_order_release);
+}
+
+int PoseHistory::GetRecentSamples(double windowTime, PoseSample *out, int maxSamples) const
+{
+    UInt64 count = writeCount.load(std::memory_order_acquire);
+    int numAvailable = (int)std::min<UInt64>(count, capacity);
+
+    int numCopied = 0;
+    for (int i = 0; i < numAvailable && numCopied < maxSamples; i++) {
+        const Slot &slot = slots[(count - 1 - i) % capacity];
+
+        UInt32 sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+        if (sequenceBefore & 1) break; // The writer has wrapped around to this slot, so everything older is being overwritten
+
+        PoseSample sample = slot.sample;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequenceBefore) break;
+
+        if (numCopied > 0 && out[0].time - sample.time > windowTime) break;
+
+        out[numCopied++] = sample;
+    }
+
+    return numCopied;
+}
+
+bool PoseHistory::EstimateVelocity(double windowTime, NiPoint3 &linearVelocityOut, NiPoint3 &angularVelocityOut) const
+{
+    PoseSample samples[capacity];
+    int numSamples = GetRecentSamples(windowTime, samples, capacity);
+    if (numSamples == 0) return false;
+
+    // Fit v(t) = a + b * t with t relative to the newest sample, so the value at the newest sample is just a
+    double t0 = samples[0].time;
+    double meanT = 0;
+    NiPoint3 meanLinear = { 0, 0, 0 };
+    NiPoint3 meanAngular = { 0, 0, 0 };
+    for (int i = 0; i < numSamples; i++) {
+        meanT += samples[i].time - t0;
+        meanLinear += samples[i].linearVelocity;
+        meanAngular += samples[i].angularVelocity;
+    }
+    meanT /= numSamples;
+    meanLinear = meanLinear / numSamples;
+    meanAngular = meanAngular / numSamples;
+
+    double varianceT = 0;
+    NiPoint3 covarianceLinear = { 0, 0, 0 };
+    NiPoint3 covarianceAngular = { 0, 0, 0 };
+    for (int i = 0; i < numSamples; i++) {
+        double dt = samples[i].time - t0 - meanT;
+        varianceT += dt * dt;
+        covarianceLinear += (samples[i].linearVelocity - meanLinear) * float(dt);
+        covarianceAngular += (samples[i].angularVelocity - meanAngular) * float(dt);
+    }
+
+    if (varianceT < 1e-9) {
+        // Only one sample, or all samples at the same time - just use the mean
+        linearVelocityOut = meanLinear;
+        angularVelocityOut = meanAngular;
+        return true;
+    }
+
+    NiPoint3 slopeLinear = covarianceLinear / float(varianceT);
+    NiPoint3 slopeAngular = covarianceAngular / float(varianceT);
+    linearVelocityOut = meanLinear - slopeLinear * float(meanT);
+    angularVelocityOut = meanAngular - slopeAngular * float(meanT);
+    return true;
+}
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "profiler.h"
+#include "ring_buffer.h"
+#include "async_log.h"
+
+
+namespace Profiler {
+    constexpr int g_maxZones = 256;
+    constexpr int g_statsWindowLength = 512; // number of samples per zone that the stats are computed over
+    constexpr size_t g_maxTraceEvents = 1 << 20;
+
+    struct Event
+    {
+        UInt64 start;
+        UInt64 end;
+        UInt16 zoneId;
+        UInt16 depth;
+    };
+
+    // Events recorded by one thread. Written only by that thread and read only by CollectFrame(), so it needs no lock.
+    struct ThreadBuffer
+    {
+        static constexpr int capacity = 4096;
+
+        Event events[capacity];
+        std::atomic<UInt64> writeCount = 0;
+        std::atomic<UInt64> readCount = 0;
+        std::atomic<UInt64> numDropped = 0; // events that didn't fit because the buffer was not collected in time
+        UInt32 threadId;
+    };
+
+    struct ZoneData
+    {
+        const char *name = nullptr;
+        RingBuffer<float, g_statsWindowLength> durationsMs{};
+        UInt64 numSamples = 0;
+    };
+
+    std::mutex g_zonesLock; // guards registration and stats, never the hot path
+    ZoneData g_zones[g_maxZones]{};
+    std::atomic<int> g_numZones = 0;
+
+    std::mutex g_threadBuffersLock;
+    std::vector<ThreadBuffer *> g_threadBuffers{}; // never freed, as the game's threads live as long as the process does
+
+    thread_local ThreadBuffer *t_threadBuffer = nullptr;
+    thread_local UInt16 t_depth = 0;
+
+    std::vector<Event> g_traceEvents{};
+    std::vector<UInt32> g_traceEventThreadIds{};
+    std::string g_traceFilename{};
+    std::atomic<int> g_traceFramesRemaining = 0; // read without the lock, to skip collecting entirely when nothing needs it
+
+    double g_ticksToMs = 0;
+
+
+    Zone::Zone(const char *name) : name(name)
+    {
+        std::scoped_lock lock(g_zonesLock);
+
+        int index = g_numZones.load();
+        if (index >= g_maxZones) {
+            // Events of this zone are dropped, rather than being mixed into another zone's stats
+            static bool hasWarned = false;
+            if (!hasWarned) {
+                AsyncLog::Warning("Too many profiler zones, %s and any zones after it will not be recorded", name);
+                hasWarned = true;
+            }
+            id = kInvalidZoneId;
+            return;
+        }
+
+        id = index;
+        g_zones[index].name = name;
+        g_numZones.store(index + 1);
+    }
+
+    UInt64 Now()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    ThreadBuffer * GetThreadBuffer()
+    {
+        if (!t_threadBuffer) {
+            t_threadBuffer = new ThreadBuffer;
+            t_threadBuffer->threadId = GetCurrentThreadId();
+
+            std::scoped_lock lock(g_threadBuffersLock);
+            g_threadBuffers.push_back(t_threadBuffer);
+        }
+        return t_threadBuffer;
+    }
+
+    void Record(UInt16 zoneId, UInt64 start, UInt64 end, UInt16 depth)
+    {
+        ThreadBuffer *buffer = GetThreadBuffer();
+
+        UInt64 writeCount = buffer->writeCount.load(std::memory_order_relaxed);
+        if (writeCount - buffer->readCount.load(std::memory_order_acquire) >= ThreadBuffer::capacity) {
+            buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer->events[writeCount % ThreadBuffer::capacity] = { start, end, zoneId, depth };
+        buffer->writeCount.store(writeCount + 1, std::memory_order_release);
+    }
+
+
+    void WriteTrace()
+    {
+        std::ofstream file;
+        file.open(g_traceFilename);
+        if (!file.is_open()) {
+            AsyncLog::Warning("Failed to open %s for writing the profiler trace", g_traceFilename.c_str());
+            return;
+        }
+
+        UInt64 firstTick = g_traceEvents.empty() ? 0 : g_traceEvents[0].start;
+        for (const Event &event : g_traceEvents) {
+            firstTick = min(firstTick, event.start);
+        }
+
+        double ticksToUs = g_ticksToMs * 1000.0;
+
+        file << "{\"traceEvents\":[\n";
+        for (size_t i = 0; i < g_traceEvents.size(); i++) {
+            const Event &event = g_traceEvents[i];
+            file << "{\"name\":\"" << g_zones[event.zoneId].name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << g_traceEventThreadIds[i]
+                << ",\"ts\":" << double(event.start - firstTick) * ticksToUs
+                << ",\"dur\":" << double(event.end - event.start) * ticksToUs
+                << ",\"args\":{\"depth\":" << event.depth << "}}";
+            file << (i + 1 < g_traceEvents.size() ? ",\n" : "\n");
+        }
+        file << "]}\n";
+        file.close();
+
+        AsyncLog::Message("Wrote %llu profiler events to %s", (UInt64)g_traceEvents.size(), g_traceFilename.c_str());
+    }
+
+    static bool IsCollectionNeeded()
+    {
+#if HIGGS_PROFILING
+        return Config::options.enableProfiler || g_traceFramesRemaining.load() > 0 || Config::options.profilerTraceFrames > 0;
+#else
+        return false; // no zones are ever entered
+#endif
+    }
+
+    void CollectFrame()
+    {
+        if (!IsCollectionNeeded()) return;
+
+        if (g_ticksToMs == 0) {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            g_ticksToMs = 1000.0 / double(frequency.QuadPart);
+        }
+
+        if (Config::options.profilerTraceFrames > 0) {
+            // Let the setting be used as a trigger, so that a capture can also be started at runtime through SetSettingDouble
+            StartTraceCapture(Config::options.profilerTraceFrames);
+            Config::options.profilerTraceFrames = 0;
+        }
+
+        std::vector<ThreadBuffer *> threadBuffers;
+        {
+            std::scoped_lock lock(g_threadBuffersLock);
+            threadBuffers = g_threadBuffers;
+        }
+
+        std::scoped_lock lock(g_zonesLock);
+
+        bool isCapturing = g_traceFramesRemaining > 0;
+
+        for (ThreadBuffer *buffer : threadBuffers) {
+            UInt64 readCount = buffer->readCount.load(std::memory_order_relaxed);
+            UInt64 writeCount = buffer->writeCount.load(std::memory_order_acquire);
+
+            for (UInt64 i = readCount; i < writeCount; i++) {
+                const Event &event = buffer->events[i % ThreadBuffer::capacity];
+
+                ZoneData &zone = g_zones[event.zoneId];
+                zone.durationsMs.Push(float(double(event.end - event.start) * g_ticksToMs));
+                ++zone.numSamples;
+
+                if (isCapturing && g_traceEvents.size() < g_maxTraceEvents) {
+                    g_traceEvents.push_back(event);
+                    g_traceEventThreadIds.push_back(buffer->threadId);
+                }
+            }
+
+            buffer->readCount.store(writeCount, std::memory_order_release);
+
+            if (UInt64 numDropped = buffer->numDropped.exchange(0, std::memory_order_relaxed)) {
+                AsyncLog::Message("Profiler dropped %llu events on thread %d", numDropped, buffer->threadId);
+            }
+        }
+
+        if (isCapturing && --g_traceFramesRemaining == 0) {
+            WriteTrace();
+            g_traceEvents.clear();
+            g_traceEvents.shrink_to_fit();
+            g_traceEventThreadIds.clear();
+            g_traceEventThreadIds.shrink_to_fit();
+        }
+    }
+
+    int GetNumZones()
+    {
+        return g_numZones.load();
+    }
+
+    bool GetZoneStats(int zoneIndex, ZoneStats &statsOut)
+    {
+        if (zoneIndex < 0 || zoneIndex >= g_numZones.load()) return false;
+
+        std::scoped_lock lock(g_zonesLock);
+
+        const ZoneData &zone = g_zones[zoneIndex];
+        int numSamples = (int)min(zone.numSamples, (UInt64)zone.durationsMs.size());
+
+        statsOut.name = zone.name;
+        statsOut.numSamples = numSamples;
+        statsOut.minMs = statsOut.avgMs = statsOut.p99Ms = statsOut.maxMs = 0.f;
+        if (numSamples == 0) return true;
+
+        float samples[g_statsWindowLength];
+        float sum = 0.f;
+        for (int i = 0; i < numSamples; i++) {
+            samples[i] = zone.durationsMs[i];
+            sum += samples[i];
+        }
+
+        auto [minIt, maxIt] = std::minmax_element(samples, samples + numSamples);
+        statsOut.minMs = *minIt;
+        statsOut.maxMs = *maxIt;
+        statsOut.avgMs = sum / numSamples;
+
+        int p99Index = min(numSamples - 1, int(numSamples * 0.99f));
+        std::nth_element(samples, samples + p99Index, samples + numSamples);
+        statsOut.p99Ms = samples[p99Index];
+
+        return true;
+    }
+
+    void StartTraceCapture(int numFrames, const char *filename)
+    {
+        if (numFrames <= 0) return;
+
+        std::scoped_lock lock(g_zonesLock);
+
+        if (g_traceFramesRemaining > 0) {
+            AsyncLog::Message("Profiler trace capture already in progress");
+            return;
+        }
+
+        if (!Config::options.enableProfiler) {
+            AsyncLog::Message("Profiler is not enabled, the trace will be empty");
+        }
+
+        g_traceFilename = filename;
+        g_traceFramesRemaining = numFrames;
+        g_traceEvents.reserve(min(g_maxTraceEvents, (size_t)numFrames * 256));
+        g_traceEventThreadIds.reserve(g_traceEvents.capacity());
+    }
+}
@@ -0,0 +1,323 @@
+#include "selection_query.h"
+#include "RE/offsets.h"
+#include "hand.h"
+#include "physics.h"
+#include "utils.h"
+#include "config.h"
+#include "math_utils.h"
+#include "profiler.h"
+#include "async_log.h"
+
+#include <Physics/Collide/Query/CastUtil/hkpLinearCastInput.h>
+#include <Physics/Collide/Query/CastUtil/hkpWorldRayCastInput.h>
+#include <Physics/Dynamics/World/hkpWorld.h>
+
+
+// Bodies that the selection casts are done with. They are never added to the world - only their collidables are used, as the shape to cast.
+// Each kind of cast has its own body so that they can be set up independently, without saving and restoring anything.
+// Heap-allocated and leaked, since the NiPointers would crash the game on exit if they were destructed.
+struct SelectionQueryBodies
+{
+    NiPointer<bhkRigidBody> nearBody = nullptr;
+    NiPointer<bhkRigidBody> widePullBody = nullptr;
+    NiPointer<bhkRigidBody> farBody = nullptr;
+};
+SelectionQueryBodies &g_selectionQueryBodies = *new SelectionQueryBodies;
+
+CdPointCollector selectionPointCollector;
+SpecificPointCollector selectionSpecificPointCollector;
+SpecificPairCollector selectionSpecificPairCollector;
+RayHitCollector selectionRayHitCollector;
+hkpLinearCastInput selectionLinearCastInput;
+hkpWorldRayCastInput selectionRayCastInput;
+
+SelectionCastStats g_selectionCastStats{};
+double g_lastSelectionCastStatsReportTime = 0;
+
+
+bool SelectionCastResult::IsFor(const NiPoint3 &start, const NiPoint3 &direction) const
+{
+    return castTime == g_currentFrameTime &&
+        start.x == castStart.x && start.y == castStart.y && start.z == castStart.z &&
+        direction.x == castDirection.x && direction.y == castDirection.y && direction.z == castDirection.z;
+}
+
+
+bhkRigidBody *CreateSelectionQueryBody()
+{
+    bhkBoxShape *shape = (bhkBoxShape *)Heap_Allocate(sizeof(bhkBoxShape));
+    if (!shape) return nullptr;
+
+    // A box with no extents is just its convex radius, i.e. a sphere
+    hkVector4 halfExtents = NiPointToHkVector({ 0.f, 0.f, 0.f });
+    bhkBoxShape_ctor(shape, &halfExtents);
+
+    bhkRigidBodyCinfo cInfo;
+    bhkRigidBodyCinfo_ctor(&cInfo);
+
+    // 'CustomPick2' layer, to pick up projectiles, because ONLY THIS GODDAMN LAYER can collide with projectiles. This filterinfo will collide with everything.
+    cInfo.collisionFilterInfo = 0x2C;
+    cInfo.hkCinfo.m_collisionFilterInfo = 0x2C;
+    cInfo.shape = shape->shape;
+    cInfo.hkCinfo.m_shape = shape->shape;
+    cInfo.hkCinfo.m_motionType = hkpMotion::MotionType::MOTION_KEYFRAMED;
+    cInfo.hkCinfo.m_enableDeactivation = false;
+    cInfo.hkCinfo.m_qualityType = hkpCollidableQualityType::HK_COLLIDABLE_QUALITY_KEYFRAMED;
+
+    bhkRigidBody *body = (bhkRigidBody *)Heap_Allocate(sizeof(bhkRigidBody));
+    if (!body) return nullptr;
+
+    bhkRigidBody_ctor(body, &cInfo);
+    return body;
+}
+
+hkpCollidable *SetupSelectionQueryBody(NiPointer<bhkRigidBody> &body, const NiPoint3 &position, float radius)
+{
+    if (!body) {
+        body = CreateSelectionQueryBody();
+        if (!body) return nullptr;
+    }
+
+    hkpRigidBody *hkBody = body->hkBody;
+    ((hkpConvexShape *)hkBody->m_collidable.m_shape)->m_radius = radius;
+    hkBody->m_motion.m_motionState.m_transform.m_translation = NiPointToHkVector(position);
+    return &hkBody->m_collidable;
+}
+
+
+void CollectSelectionCandidates(SelectionCastResult &result)
+{
+    result.candidates.clear();
+    for (auto &pair : selectionPointCollector.m_hits) {
+        hkpCollidable *collidable = static_cast<hkpCollidable *>(pair.first);
+        hkpRigidBody *rigidBody = hkpGetRigidBody(collidable);
+        if (!rigidBody || !rigidBody->m_userData) {
+            continue; // No rigidbody -> no movement :/
+        }
+
+        SelectionCandidate &candidate = result.candidates.emplace_back();
+        candidate.collidable = collidable;
+        candidate.rigidBody = (bhkRigidBody *)rigidBody->m_userData;
+        candidate.ref = GetRefFromCollidable(collidable);
+        candidate.point = pair.second.getPosition();
+        candidate.filterInfo = collidable->getCollisionFilterInfo();
+        candidate.isSelectable = candidate.ref && IsObjectSelectable(rigidBody, candidate.ref);
+        candidate.isProjectileInFlight = false;
+        if (candidate.ref && candidate.ref->baseForm->formType == kFormType_Projectile) {
+            auto impactData = *(void **)((UInt64)candidate.ref.m_pObject + 0x98);
+            candidate.isProjectileInFlight = !impactData;
+        }
+    }
+}
+
+
+void CastSelectionNear(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, bhkRigidBody *pulledBody, HandSelectionQueries &queries)
+{
+    SelectionCastResult &result = queries.nearCast;
+    result.candidates.clear();
+    result.castStart = start;
+    result.castDirection = direction;
+    result.castTime = g_currentFrameTime;
+    queries.widePullTarget = nullptr;
+
+    hkpCollidable *collidable = SetupSelectionQueryBody(g_selectionQueryBodies.nearBody, start, Config::options.nearCastRadius);
+    if (!collidable) return;
+
+    selectionLinearCastInput.m_to = NiPointToHkVector(start + direction * Config::options.nearCastDistance);
+    selectionPointCollector.reset();
+    hkpWorld_LinearCast(world->world, collidable, &selectionLinearCastInput, &selectionPointCollector, &selectionPointCollector);
+    CollectSelectionCandidates(result);
+
+    if (pulledBody) {
+        // Also check for the pulled object in a wider radius, for when nothing is found normally
+        if (hkpCollidable *wideCollidable = SetupSelectionQueryBody(g_selectionQueryBodies.widePullBody, start, Config::options.widePullGrabRadius)) {
+            selectionSpecificPairCollector.reset();
+            selectionSpecificPairCollector.m_target = &pulledBody->hkBody->m_collidable;
+            hkpWorld_GetPenetrations(world->world, wideCollidable, world->world->m_collisionInput, &selectionSpecificPairCollector);
+
+            if (selectionSpecificPairCollector.m_foundTarget) {
+                queries.widePullTarget = &pulledBody->hkBody->m_collidable;
+            }
+        }
+    }
+}
+
+
+bool CanReuseFarSweep(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, const HandSelectionQueries &queries)
+{
+    if (g_currentFrameTime - queries.farSweepTime >= Config::options.farCastCoherenceMaxAge) return false;
+
+    if (VectorLength(start - queries.farSweepStart) > Config::options.farCastCoherenceMaxDistance) return false;
+    if (DotProduct(direction, queries.farSweepDirection) < cosf(Config::options.farCastCoherenceMaxAngle * 0.0174533)) return false; // degrees to radians
+
+    // Something started or stopped moving somewhere, so objects may have come into or left the swept volume
+    if (world->world->m_activeSimulationIslands.getSize() != queries.farSweepNumActiveIslands) return false;
+
+    for (const SelectionCandidate &candidate : queries.farCast.candidates) {
+        hkpRigidBody *hkBody = candidate.rigidBody->hkBody;
+
+        // The body may have been removed from the world or moved to a different one, or its collision given to a different reference since the sweep
+        if (hkBody->getWorld() != world->world) return false;
+        if (candidate.ref != GetRefFromCollidable(&hkBody->m_collidable)) return false;
+
+        hkpMotion *motion = hkBody->getMotion();
+        if (VectorLength(HkVectorToNiPoint(motion->m_linearVelocity)) > 0.01f) {
+            return false; // One of the hits is moving, so the hit point is out of date
+        }
+    }
+
+    return true;
+}
+
+void CastSelectionFar(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, UInt16 playerCollisionGroup, HandSelectionQueries &queries)
+{
+    SelectionCastResult &result = queries.farCast;
+
+    if (CanReuseFarSweep(world, start, direction, queries)) {
+        // Keep the candidates - they are scored against the current pose when the hand picks from them
+        result.castStart = start;
+        result.castDirection = direction;
+        result.castTime = g_currentFrameTime;
+        ++g_selectionCastStats.numFarSweepsSkipped;
+        return;
+    }
+
+    result.candidates.clear();
+    result.castStart = start;
+    result.castDirection = direction;
+    result.castTime = g_currentFrameTime;
+
+    queries.farSweepStart = start;
+    queries.farSweepDirection = direction;
+    queries.farSweepTime = g_currentFrameTime;
+    queries.farSweepNumActiveIslands = world->world->m_activeSimulationIslands.getSize();
+    ++g_selectionCastStats.numFarSweeps;
+
+    NiPoint3 hkTargetPos = start + direction * Config::options.farCastDistance;
+    NiPoint3 hitPosition = hkTargetPos;
+
+    // First, raycast in the pointing direction
+    selectionRayHitCollector.reset();
+    selectionRayCastInput.m_filterInfo = ((UInt32)playerCollisionGroup << 16) | 0x28;
+    selectionRayCastInput.m_from = NiPointToHkVector(start);
+    selectionRayCastInput.m_to = NiPointToHkVector(hkTargetPos);
+    hkpWorld_CastRay(world->world, &selectionRayCastInput, &selectionRayHitCollector);
+    if (selectionRayHitCollector.m_doesHitExist) {
+        // If raycast hit, we want to linearcast only up to the ray hit location
+        hitPosition = start + (hkTargetPos - start) * selectionRayHitCollector.m_closestHitInfo.m_hitFraction;
+    }
+
+    hkpCollidable *collidable = SetupSelectionQueryBody(g_selectionQueryBodies.farBody, start, Config::options.farCastRadius);
+    if (!collidable) return;
+
+    // Now, linearcast up to the point the raycast hit, or up to the limit if it's empty space
+    selectionLinearCastInput.m_to = NiPointToHkVector(hitPosition);
+    selectionPointCollector.reset();
+    hkpWorld_LinearCast(world->world, collidable, &selectionLinearCastInput, &selectionPointCollector, &selectionPointCollector);
+    CollectSelectionCandidates(result);
+}
+
+
+bool CastSelectionNearAgainst(bhkWorld *world, const NiPoint3 &start, const NiPoint3 &direction, hkpCollidable *target, hkVector4 &hitPoint)
+{
+    hkpCollidable *collidable = SetupSelectionQueryBody(g_selectionQueryBodies.nearBody, start, Config::options.nearCastRadius);
+    if (!collidable) return false;
+
+    selectionLinearCastInput.m_to = NiPointToHkVector(start + direction * Config::options.nearCastDistance);
+    selectionSpecificPointCollector.reset();
+    selectionSpecificPointCollector.m_target = target;
+    hkpWorld_LinearCast(world->world, collidable, &selectionLinearCastInput, &selectionSpecificPointCollector, &selectionSpecificPointCollector);
+
+    if (selectionSpecificPointCollector.m_foundTarget) {
+        hitPoint = selectionSpecificPointCollector.m_contactPoint.getPosition();
+        return true;
+    }
+    return false;
+}
+
+
+bool IsSelectingState(Hand::State state)
+{
+    return state == Hand::State::Idle || state == Hand::State::SelectedClose || state == Hand::State::SelectedFar || state == Hand::State::SelectedTwoHand;
+}
+
+bool WillFindCloseObject(const HandSelectionQueries &queries)
+{
+    // Approximation of whether FindCloseObject() will find something, without the checks that depend on the other hand
+    if (queries.widePullTarget) return true;
+
+    PlayerCharacter *player = *g_thePlayer;
+    for (const SelectionCandidate &candidate : queries.nearCast.candidates) {
+        if (candidate.ref && candidate.ref != player && candidate.isSelectable && !candidate.isProjectileInFlight) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RunSelectionQueries(bhkWorld *world, Hand &rightHand, Hand &leftHand)
+{
+    HIGGS_PROFILE_ZONE("RunSelectionQueries");
+    PlayerCharacter *player = *g_thePlayer;
+    if (!player || !player->GetNiNode()) return;
+
+    float havokWorldScale = *g_havokWorldScale;
+
+    struct PendingQuery
+    {
+        Hand *hand;
+        NiPoint3 hkPalmPos;
+        NiPoint3 palmVector;
+        NiPoint3 pointingVector;
+        bool doFar;
+    };
+
+    PendingQuery pending[2];
+    int numPending = 0;
+
+    for (Hand *hand : { &rightHand, &leftHand }) {
+        bool isSelecting = IsSelectingState(hand->state);
+        if (!isSelecting && hand->state != Hand::State::SelectionLocked) continue;
+        if (!hand->CanHoldObject()) continue;
+
+        NiPointer<NiAVObject> handNode = hand->GetFirstPersonHandNode();
+        if (!handNode) continue;
+
+        PendingQuery &query = pending[numPending++];
+        query.hand = hand;
+        query.hkPalmPos = hand->GetPalmPositionWS(handNode->m_worldTransform) * havokWorldScale;
+        query.palmVector = hand->GetPalmVectorWS(handNode->m_worldTransform.rot);
+        query.pointingVector = hand->GetPointingVectorWS(handNode->m_worldTransform.rot);
+        query.doFar = isSelecting && !hand->ShouldRestrictPull();
+    }
+
+    if (numPending == 0) return;
+
+    UInt16 playerCollisionGroup = 0;
+    if (NiPointer<NiAVObject> comNode = rightHand.GetComNode()) {
+        if (NiPointer<bhkRigidBody> comRigidBody = GetRigidBody(comNode)) {
+            playerCollisionGroup = comRigidBody->hkBody->m_collidable.m_broadPhaseHandle.m_collisionFilterInfo >> 16;
+        }
+    }
+
+    world->worldLock.LockForRead();
+
+    for (int i = 0; i < numPending; i++) {
+        PendingQuery &query = pending[i];
+        Hand &hand = *query.hand;
+
+        CastSelectionNear(world, query.hkPalmPos, query.palmVector, hand.pulledObject.rigidBody, hand.selectionQueries);
+
+        // Far casts are only needed when nothing is close by. If something near gets filtered out by the hand, it'll just do the far cast itself.
+        if (query.doFar && !WillFindCloseObject(hand.selectionQueries)) {
+            CastSelectionFar(world, query.hkPalmPos, query.pointingVector, playerCollisionGroup, hand.selectionQueries);
+        }
+    }
+
+    world->worldLock.UnlockRead();
+
+    if (g_currentFrameTime - g_lastSelectionCastStatsReportTime > 10.0) {
+        HIGGS_VMESSAGE(Selection, "Far selection casts: %llu swept, %llu reused", g_selectionCastStats.numFarSweeps, g_selectionCastStats.numFarSweepsSkipped);
+        g_lastSelectionCastStatsReportTime = g_currentFrameTime;
+    }
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <list>
 #include <string>
@@ -15,6 +16,8 @@
 #include "utils.h"
 #include "config.h"
 #include "hand.h"
+#include "profiler.h"
+#include "async_log.h"
 
 
 UInt32 g_bipedObjectPriorities[] = { // lower is better
@@ -104,6 +107,29 @@ double GetTime()
     return g_timer.GetElapsedTime();
 }
 
+UInt32 g_playerNodesGeneration = 0;
+UInt32 UpdatePlayerNodesGeneration()
+{
+    // Hold references to the roots we last saw so that a new root can't be allocated at the same address and go unnoticed.
+    // Leaked, since the NiPointers would crash the game on exit if they were destructed.
+    static NiPointer<NiNode> *lastRoots = new NiPointer<NiNode>[2]{};
+
+    PlayerCharacter *player = *g_thePlayer;
+    NiNode *roots[2] = { nullptr, nullptr };
+    if (player && player->loadedState) {
+        roots[0] = player->GetNiRootNode(0);
+        roots[1] = player->GetNiRootNode(1);
+    }
+
+    if (roots[0] != lastRoots[0] || roots[1] != lastRoots[1]) {
+        lastRoots[0] = roots[0];
+        lastRoots[1] = roots[1];
+        ++g_playerNodesGeneration;
+    }
+
+    return g_playerNodesGeneration;
+}
+
 NiAVObject * GetHighestParent(NiAVObject *node)
 {
     if (!node->m_parent) {
@@ -258,6 +284,51 @@ NiTransform GetRigidBodyTLocalTransform(bhkRigidBody *rigidBody)
     return rigidBodyLocalTransform;
 }
 
+void CollectSkinnedGeometry(NiAVObject *obj, std::vector<SkinnedGeometry> &geometryOut, std::vector<SubtreeNode> *nodesOut)
+{
+    if (BSGeometry *geom = obj->GetAsBSGeometry()) {
+        if (NiSkinInstance *skinInstance = geom->m_spSkinInstance) {
+            geometryOut.push_back({ geom, skinInstance });
+        }
+    }
+
+    if (NiNode *node = obj->GetAsNiNode()) {
+        if (nodesOut) {
+            nodesOut->push_back({ node, node->m_children.m_emptyRunStart });
+        }
+
+        for (int i = 0; i < node->m_children.m_emptyRunStart; i++) {
+            if (NiAVObject *child = node->m_children.m_data[i]) {
+                CollectSkinnedGeometry(child, geometryOut, nodesOut);
+            }
+        }
+    }
+}
+
+bool HasSubtreeChanged(const std::vector<SubtreeNode> &nodes)
+{
+    for (size_t i = 0; i < nodes.size(); i++) {
+        NiNode *node = nodes[i].node;
+        if (node->m_children.m_emptyRunStart != nodes[i].numChildren) return true;
+        if (i > 0 && !node->m_parent) return true; // detached from the subtree, along with everything under it
+    }
+    return false;
+}
+
+bool UpdateBoneMatrices(const std::vector<SkinnedGeometry> &skinnedGeometry)
+{
+    for (const SkinnedGeometry &skinned : skinnedGeometry) {
+        BSGeometry *geom = skinned.geometry;
+        if (!geom->m_parent || geom->m_spSkinInstance != skinned.skinInstance) {
+            return false;
+        }
+
+        skinned.skinInstance->unk38 = -1; // This is the frameID. UpdateBoneMatrices only updates the bone matrices if the frameID is not equal to the current frame.
+        NiSkinInstance_UpdateBoneMatrices(skinned.skinInstance, geom->m_worldTransform);
+    }
+    return true;
+}
+
 void UpdateBoneMatrices(NiAVObject *obj)
 {
     if (BSGeometry *geom = obj->GetAsBSGeometry()) {
@@ -277,8 +348,39 @@ void UpdateBoneMatrices(NiAVObject *obj)
     }
 }
 
-void UpdateKeyframedNode(NiAVObject *node, NiTransform &transform)
+bool KeyframedNodeInfo::IsFor(NiAVObject *node) const
+{
+    return node == this->node && GetCollisionObject(node) == collisionObject && !isSkinnedGeometryStale;
+}
+
+void ClassifyKeyframedNode(NiAVObject *node, KeyframedNodeInfo &infoOut)
+{
+    infoOut = {};
+    infoOut.node = node;
+    infoOut.collisionObject = GetCollisionObject(node);
+
+    if (infoOut.collisionObject) {
+        infoOut.blendCollisionObject = DYNAMIC_CAST(infoOut.collisionObject, bhkCollisionObject, bhkBlendCollisionObject);
+    }
+
+    infoOut.rigidBody = GetRigidBody(node);
+    if (infoOut.rigidBody) {
+        if (DYNAMIC_CAST(infoOut.rigidBody, bhkRigidBody, bhkRigidBodyT)) {
+            infoOut.isRigidBodyT = true;
+            infoOut.rigidBodyTLocalTransform = GetRigidBodyTLocalTransform(infoOut.rigidBody);
+        }
+    }
+
+    CollectSkinnedGeometry(node, infoOut.skinnedGeometry, &infoOut.subtreeNodes);
+}
+
+std::vector<KeyframedNodeInfo *> g_pendingKeyframedNodes{};
+
+void UpdateKeyframedNode(KeyframedNodeInfo &info, const NiTransform &transform)
 {
+    HIGGS_PROFILE_ZONE("UpdateKeyframedNode");
+    NiAVObject *node = info.node;
+
     UpdateNodeTransformLocal(node, transform);
 
     NiAVObject::ControllerUpdateContext ctx;
@@ -286,37 +388,54 @@ void UpdateKeyframedNode(NiAVObject *node, NiTransform &transform)
     ctx.delta = 0;
     NiAVObject_UpdateNode(node, &ctx); // This will set the collision object's velocity as well
 
-    if (bhkCollisionObject *collisionObject = GetCollisionObject(node)) {
-        if (bhkBlendCollisionObject *blendCollisionObject = DYNAMIC_CAST(collisionObject, bhkCollisionObject, bhkBlendCollisionObject)) {
-            // The bhkBlendCollisionObject update function does not have a case where it checks if it's keyframed (and thus would do a node->collision update instead of a collision->node update) like the bhkCollisionObject update does.
-            // So, I need to do it myself.
-            if (NiPointer<bhkRigidBody> rigidBody = GetRigidBody(node)) {
-                rigidBody->flags |= (1 << 6); // I'm not 100% sure what the true purpose of this flag is, but the bhkBlendCollisionObject update function skips updating the node from the collision if it's set, which is handy for me.
-                UpdateNodeTransformLocal(node, transform);
-                blendCollisionObject->UpdateCollisionFromNodeTransform();
-            }
-        }
+    if (info.blendCollisionObject && info.rigidBody) {
+        // The bhkBlendCollisionObject update function does not have a case where it checks if it's keyframed (and thus would do a node->collision update instead of a collision->node update) like the bhkCollisionObject update does.
+        // So, I need to do it myself.
+        info.rigidBody->flags |= (1 << 6); // I'm not 100% sure what the true purpose of this flag is, but the bhkBlendCollisionObject update function skips updating the node from the collision if it's set, which is handy for me.
+        UpdateNodeTransformLocal(node, transform);
+        info.blendCollisionObject->UpdateCollisionFromNodeTransform();
     }
 
-    if (NiPointer<bhkRigidBody> rigidBody = GetRigidBody(node)) {
-        bhkRigidBody_setActivated(rigidBody, 1);
+    if (info.rigidBody) {
+        bhkRigidBody_setActivated(info.rigidBody, 1);
 
-        if (bhkRigidBodyT *rigidBodyT = DYNAMIC_CAST(rigidBody, bhkRigidBody, bhkRigidBodyT)) {
+        if (info.isRigidBodyT) {
             // bhkRigidBodyT means the collision object is offset from the node. Bethesda didn't code it correctly in the node update when using the velocity flag for this case, so I have to do it myself.
 
-            NiTransform rigidBodyTransform = transform * GetRigidBodyTLocalTransform(rigidBodyT);
+            NiTransform rigidBodyTransform = transform * info.rigidBodyTLocalTransform;
 
             NiPoint3 pos = rigidBodyTransform.pos;
             NiQuaternion rot = MatrixToQuaternion(rigidBodyTransform.rot);
 
             //bhkRigidBody_MoveToPositionAndRotation(rigidBody, pos, rot); // This doesn't work because this function does stuff like read the collision object's center of mass without compensating for bhkRigidBodyT transformations...
-            ApplyHardKeyframeVelocityClamped(NiPointToHkVector(pos * *g_havokWorldScale), NiQuatToHkQuat(rot), 1.0f / *g_deltaTime, rigidBody);
+            ApplyHardKeyframeVelocityClamped(NiPointToHkVector(pos * *g_havokWorldScale), NiQuatToHkQuat(rot), 1.0f / *g_deltaTime, info.rigidBody);
         }
     }
 
-    UpdateBoneMatrices(node); // Update skinned geometry on the object so that it's not a frame behind
+    auto isNode = [node](const KeyframedNodeInfo *pending) { return pending->node == node; };
+    if (std::none_of(g_pendingKeyframedNodes.begin(), g_pendingKeyframedNodes.end(), isNode)) {
+        g_pendingKeyframedNodes.push_back(&info);
+    }
+}
+
+void FlushKeyframedNodes()
+{
+    HIGGS_PROFILE_ZONE("FlushKeyframedNodes");
+
+    for (KeyframedNodeInfo *info : g_pendingKeyframedNodes) {
+        NiAVObject *node = info->node;
+
+        // Update skinned geometry on the object so that it's not a frame behind
+        if (HasSubtreeChanged(info->subtreeNodes) || !UpdateBoneMatrices(info->skinnedGeometry)) {
+            // The node's 3d changed under us, so do it the slow way this time and have the list collected again next frame
+            info->isSkinnedGeometryStale = true;
+            UpdateBoneMatrices(node);
+        }
+
+        ShadowSceneNode_UpdateNodeList(*g_shadowSceneNode, node, false); // Gets shadows to update since keyframed nodes are not "dynamic" and so the game doesn't think they can move
+    }
 
-    ShadowSceneNode_UpdateNodeList(*g_shadowSceneNode, node, false); // Gets shadows to update since keyframed nodes are not "dynamic" and so the game doesn't think they can move
+    g_pendingKeyframedNodes.clear();
 }
 
 bool GetAnimVariableBool(Actor *actor, BSFixedString &variableName)
@@ -439,12 +558,12 @@ bool ShouldNotHaveMeleeCollision(TESForm *equippedObject)
 
 void PrintVector(const NiPoint3 &p)
 {
-    _MESSAGE("%.2f, %.2f, %.2f", p.x, p.y, p.z);
+    AsyncLog::Message("%.2f, %.2f, %.2f", p.x, p.y, p.z);
 }
 
 void PrintQuat(const NiQuaternion &q)
 {
-    _MESSAGE("%f, %f, %f, %f", q.m_fW, q.m_fX, q.m_fY, q.m_fZ);
+    AsyncLog::Message("%f, %f, %f, %f", q.m_fW, q.m_fX, q.m_fY, q.m_fZ);
 }
 
 std::vector<std::string> SplitString(const std::string &s, char delim)
@@ -617,7 +736,7 @@ std::string PrintNodeToString(NiAVObject *avObj, int depth)
 
 bool PrintNodes(NiAVObject *avObj, int depth)
 {
-    gLog.Message(PrintNodeToString(avObj, depth).c_str());
+    AsyncLog::Message("%s", PrintNodeToString(avObj, depth).c_str());
     return false;
 }
 
@@ -1302,6 +1421,55 @@ void ForEachAdjacentBody(NiAVObject *root, bhkRigidBody *body, std::function<voi
     }
 }
 
+void BuildConstrainedBodySnapshot(NiAVObject *root, bhkRigidBody *grabbedBody, int adjacencyWaves, bool isRagdolled, ConstrainedBodySnapshot &snapshotOut)
+{
+    snapshotOut = {};
+    snapshotOut.root = root;
+    snapshotOut.grabbedBody = grabbedBody;
+    snapshotOut.numGrabbedBodyConstraints = grabbedBody->constraints.count;
+    snapshotOut.adjacencyWaves = adjacencyWaves;
+    snapshotOut.isRagdolled = isRagdolled;
+
+    std::set<NiPointer<bhkRigidBody>> connectedBodies;
+    snapshotOut.isAttachedToFixed = CollectAllGrabbedRigidBodies(root, grabbedBody, connectedBodies);
+    snapshotOut.connectedBodies.assign(connectedBodies.begin(), connectedBodies.end());
+
+    if (adjacencyWaves > 0) {
+        ForEachAdjacentBody(root, grabbedBody, [&snapshotOut](hkpRigidBody *adjacentBody) {
+            snapshotOut.adjacentBodies.push_back((bhkRigidBody *)adjacentBody->m_userData);
+        }, adjacencyWaves);
+    }
+
+    std::vector<NiPointer<bhkConstraint>> constraints;
+    CollectAllConstraints(root, constraints);
+    snapshotOut.constraints.reserve(constraints.size());
+    for (bhkConstraint *constraint : constraints) {
+        bool isEnabled; hkpConstraintInstance_isEnabled(constraint->constraint, &isEnabled);
+        snapshotOut.constraints.push_back({ constraint, isEnabled, constraint->constraint->getOwner() != nullptr });
+    }
+}
+
+bool IsConstrainedBodySnapshotValid(ConstrainedBodySnapshot &snapshot, NiAVObject *root, bhkRigidBody *grabbedBody, int adjacencyWaves, bool isRagdolled)
+{
+    constexpr size_t numConstraintsToVerifyPerCall = 4;
+
+    if (root != snapshot.root || grabbedBody != snapshot.grabbedBody) return false;
+    if (adjacencyWaves != snapshot.adjacencyWaves || isRagdolled != snapshot.isRagdolled) return false;
+    if (grabbedBody->constraints.count != snapshot.numGrabbedBodyConstraints) return false;
+
+    size_t numConstraints = snapshot.constraints.size();
+    for (size_t i = 0; i < min(numConstraints, numConstraintsToVerifyPerCall); i++) {
+        ConstrainedBodySnapshot::ConstraintState &state = snapshot.constraints[snapshot.nextConstraintToVerify];
+        snapshot.nextConstraintToVerify = (snapshot.nextConstraintToVerify + 1) % numConstraints;
+
+        hkpConstraintInstance *constraint = state.constraint->constraint;
+        bool isEnabled; hkpConstraintInstance_isEnabled(constraint, &isEnabled);
+        if (isEnabled != state.isEnabled || (constraint->getOwner() != nullptr) != state.isAddedToWorld) return false;
+    }
+
+    return true;
+}
+
 bool IsHandUsingIndexController(bool leftHand)
 {
     if (g_openVR && *g_openVR) {